@@ -5,21 +5,30 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <any>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <optional>
 #include <ostream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <typeinfo>
 #include <utility>
-#include <unordered_map>
+#include <vector>
 
 #include <hpx/futures/future.hpp>
 #include <hpx/hpx_init.hpp>
@@ -29,11 +38,20 @@
 #include <hpx/lcos/promise.hpp>
 //#include <hpx/synchronization/mutex.hpp> // obsolete
 #include <hpx/mutex.hpp>
-
-#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
-// required for defining type traits using cuda executor as underlying
-// aggregation executors
-#include <hpx/async_cuda/cuda_executor.hpp>
+#include <hpx/runtime_local/shutdown_function.hpp>
+#include <hpx/runtime_local/thread_pool_helpers.hpp>
+#include <hpx/thread.hpp>
+
+#include <hpx/config.hpp>
+#if defined(HPX_VERSION_FULL) && HPX_VERSION_FULL >= 0x010800
+// Sender/receiver (P2300) interface for executor slices and stream interfaces
+#include <hpx/execution.hpp>
+#define CPPUDDLE_HAVE_AGGREGATION_SENDERS
+#endif
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+// C++20 awaitables for slice requests and aggregated calls
+#include <coroutine>
+#define CPPUDDLE_HAVE_AGGREGATION_COROUTINES
 #endif
 
 #include <boost/core/demangle.hpp>
@@ -59,6 +77,78 @@ std::tuple<Ts...> make_tuple_supporting_references(Ts &&...ts) {
   return std::tuple<Ts...>{std::forward<Ts>(ts)...};
 }
 
+/// Vector-like container with a fixed capacity and inline storage (no heap
+/// allocations) -- holds the per-slice entries of aggregation executors with
+/// a compile-time number of slices
+template <typename T, size_t capacity> class fixed_capacity_vector {
+private:
+  alignas(T) unsigned char storage[capacity * sizeof(T)];
+  size_t number_elements{0};
+
+public:
+  fixed_capacity_vector(void) = default;
+  ~fixed_capacity_vector(void) { clear(); }
+  fixed_capacity_vector(const fixed_capacity_vector &other) = delete;
+  fixed_capacity_vector &operator=(const fixed_capacity_vector &other) = delete;
+  fixed_capacity_vector(fixed_capacity_vector &&other) {
+    for (auto &element : other)
+      emplace_back(std::move(element));
+    other.clear();
+  }
+  fixed_capacity_vector &operator=(fixed_capacity_vector &&other) {
+    clear();
+    for (auto &element : other)
+      emplace_back(std::move(element));
+    other.clear();
+    return *this;
+  }
+
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    assert(number_elements < capacity);
+    T *element = new (storage + number_elements * sizeof(T))
+        T(std::forward<Args>(args)...);
+    number_elements++;
+    return *element;
+  }
+  void push_back(T &&element) { emplace_back(std::move(element)); }
+  void pop_back(void) {
+    assert(number_elements > 0);
+    number_elements--;
+    data()[number_elements].~T();
+  }
+  /// Only supports growing an empty container
+  void resize(const size_t new_size) {
+    assert(number_elements == 0 && new_size <= capacity);
+    for (size_t i = 0; i < new_size; i++)
+      emplace_back();
+  }
+  void clear(void) {
+    for (auto &element : *this)
+      element.~T();
+    number_elements = 0;
+  }
+
+  T *data(void) { return std::launder(reinterpret_cast<T *>(storage)); }
+  const T *data(void) const {
+    return std::launder(reinterpret_cast<const T *>(storage));
+  }
+  T &operator[](const size_t i) { return data()[i]; }
+  T &back(void) { return data()[number_elements - 1]; }
+  size_t size(void) const { return number_elements; }
+  bool empty(void) const { return number_elements == 0; }
+  T *begin(void) { return data(); }
+  T *end(void) { return data() + number_elements; }
+  const T *begin(void) const { return data(); }
+  const T *end(void) const { return data() + number_elements; }
+};
+
+/// Storage for per-slice entries: std::vector if the number of slices is
+/// only known at runtime (fixed_slices == 0), inline storage otherwise
+template <typename T, size_t fixed_slices>
+using slice_storage_t =
+    std::conditional_t<fixed_slices == 0, std::vector<T>,
+                       fixed_capacity_vector<T, fixed_slices>>;
+
 /// Print some specific values that we can, but don't bother for most types
 /// (such as vector)
 template <typename T> std::string print_if_possible(T val) {
@@ -92,13 +182,35 @@ template <class... T> void print_tuple(const std::tuple<T...> &_tup) {
   // address to 1...
   // TODO Try using std::format as soon as we can move to C++20
   std::unique_ptr<char[]> debug_string(new char[128]());
-  snprintf(debug_string.get(), 128, "Function address: %p -- Arguments: (",
-           std::get<0>(_tup));
+  if constexpr (std::is_pointer_v<std::decay_t<decltype(std::get<0>(_tup))>>) {
+    snprintf(debug_string.get(), 128, "Function address: %p -- Arguments: (",
+             std::get<0>(_tup));
+  } else {
+    // Function objects (e.g. the launcher of bulk calls) have no address
+    // worth printing
+    snprintf(debug_string.get(), 128, "Function object -- Arguments: (");
+  }
   hpx::cout << debug_string.get();
   print_tuple(_tup, std::make_index_sequence<sizeof...(T) - 1>());
   hpx::cout << ")";
 }
 
+/// Helper trait for the debug checks: Can T be compared with ==?
+template <typename T, typename = void>
+struct is_equality_comparable : std::false_type {};
+template <typename T>
+struct is_equality_comparable<
+    T, std::void_t<decltype(std::declval<const T &>() ==
+                            std::declval<const T &>())>> : std::true_type {};
+
+/// Helper trait for the debug checks: Can the values of a call tuple be
+/// compared? (not the case for lambdas, e.g. the ones created by the HPX
+/// parallel algorithms) -- otherwise only the types get checked
+template <class TupType> struct call_values_comparable : std::false_type {};
+template <class... T>
+struct call_values_comparable<std::tuple<T...>>
+    : std::conjunction<is_equality_comparable<std::remove_reference_t<T>>...> {};
+
 //===============================================================================
 //===============================================================================
 template <typename Executor, typename F, typename... Ts>
@@ -111,6 +223,226 @@ hpx::lcos::future<void> exec_async_wrapper(Executor & exec, F &&f, Ts &&...ts) {
   return hpx::async(exec, std::forward<F>(f), std::forward<Ts>(ts)...);
 }
 
+/// Part of an aggregated bulk call as declared by one slice (its callable,
+/// shape and arguments)
+struct aggregated_bulk_part {
+  virtual ~aggregated_bulk_part() = default;
+  /// Calls the callable for all elements of the shape
+  virtual void run(void) = 0;
+  /// Is other the identical call (same callable, shape and argument values)?
+  /// Always false for calls that cannot be compared (lambdas, for instance)
+  /// or that return values
+  virtual bool same_call(const aggregated_bulk_part &other) const = 0;
+};
+
+/// Bulk part calling f(element, ts...) for all elements of the shape --
+/// R is the result type of f
+template <typename R, typename F, typename Shape, typename... Ts>
+class aggregated_bulk_call final : public aggregated_bulk_part {
+  using call_tuple_t = std::tuple<F, Shape, Ts...>;
+  call_tuple_t call;
+  /// One result per element of the shape (unused if R is void) -- stored by
+  /// run and handed out with publish_results
+  using value_t = std::conditional_t<std::is_void_v<R>, std::nullptr_t, R>;
+  std::vector<std::optional<value_t>> values;
+  std::vector<std::exception_ptr> errors;
+  std::vector<hpx::lcos::local::promise<R>> results;
+
+public:
+  template <typename... Args>
+  explicit aggregated_bulk_call(Args &&...args)
+      : call(std::forward<Args>(args)...) {
+    if constexpr (!std::is_void_v<R>) {
+      const Shape &shape = std::get<1>(call);
+      const size_t number_elements =
+          std::distance(std::begin(shape), std::end(shape));
+      values.resize(number_elements);
+      errors.resize(number_elements);
+      results.resize(number_elements);
+    }
+  }
+  /// Futures of the element results (see publish_results)
+  std::vector<hpx::lcos::future<R>> get_results(void) {
+    std::vector<hpx::lcos::future<R>> result_futures;
+    result_futures.reserve(results.size());
+    for (auto &result : results)
+      result_futures.push_back(result.get_future());
+    return result_futures;
+  }
+  void run(void) override {
+    std::apply(
+        [this](auto &f, const auto &shape, auto &...ts) {
+          if constexpr (std::is_void_v<R>) {
+            for (const auto &element : shape)
+              std::invoke(f, element, ts...);
+          } else {
+            size_t element_index = 0;
+            for (const auto &element : shape) {
+              try {
+                values[element_index].emplace(std::invoke(f, element, ts...));
+              } catch (...) {
+                errors[element_index] = std::current_exception();
+              }
+              element_index++;
+            }
+          }
+        },
+        call);
+  }
+  /// Makes the element results ready -- only once the slice got notified
+  /// about the end of the aggregated launch (the futures must not outlive
+  /// the aggregated call otherwise). Elements that did not run get
+  /// launch_exception
+  void publish_results(std::exception_ptr launch_exception) {
+    for (size_t i = 0; i < results.size(); i++) {
+      if (values[i].has_value()) {
+        results[i].set_value(std::move(*values[i]));
+      } else if (errors[i]) {
+        results[i].set_exception(errors[i]);
+      } else {
+        results[i].set_exception(
+            launch_exception
+                ? launch_exception
+                : std::make_exception_ptr(std::runtime_error(
+                      "Aggregated bulk call did not run this element")));
+      }
+    }
+  }
+  bool same_call(const aggregated_bulk_part &other) const override {
+    if constexpr (std::is_void_v<R> &&
+                  call_values_comparable<call_tuple_t>::value) {
+      const auto *other_call =
+          dynamic_cast<const aggregated_bulk_call *>(&other);
+      return other_call != nullptr && other_call->call == call;
+    } else {
+      return false;
+    }
+  }
+};
+
+/// Launched instead of the function of an aggregated bulk call: runs the bulk
+/// parts of all slices -- all within the one aggregated launch on the
+/// underlying executor
+/** Identical parts (e.g. all slices calling f for all elements of their
+ * aggregated buffers) run only once. The parts run on the host: Whatever the
+ * underlying executor appends to the arguments of its launches (ts) is not
+ * passed on to the element calls.
+ */
+struct aggregated_bulk_launcher {
+  template <typename... Ts>
+  void operator()(std::vector<std::shared_ptr<aggregated_bulk_part>> parts,
+                  Ts &&...) const {
+    for (size_t i = 0; i < parts.size(); i++) {
+      const bool repeated_call =
+          std::any_of(parts.begin(), parts.begin() + i,
+                      [&](const auto &part) {
+                        return part->same_call(*parts[i]);
+                      });
+      if (!repeated_call)
+        parts[i]->run();
+    }
+  }
+};
+
+/// Launched instead of the function of a fused aggregated call: runs the
+/// number_calls calls of the composite (tuples of a kernel and its arguments)
+/// back to back -- all within the one aggregated launch on the underlying
+/// executor
+/** Whatever the underlying executor appends to the arguments of its launches
+ * (the stream of a CUDA executor, for instance) follows the calls and gets
+ * passed on to each kernel (see aggregated_copy_launcher)
+ */
+template <size_t number_calls> struct aggregated_fused_launcher {
+  template <typename... Args> void operator()(Args &&...args) const {
+    static_assert(sizeof...(Args) >= number_calls,
+                  "Fused launch is missing calls");
+    auto arguments = std::forward_as_tuple(args...);
+    launch_calls(arguments, std::make_index_sequence<number_calls>{},
+                 std::make_index_sequence<sizeof...(Args) - number_calls>{});
+  }
+  /// Stateless -- required for the debug checks of the call arguments
+  friend constexpr bool operator==(const aggregated_fused_launcher &,
+                                   const aggregated_fused_launcher &) noexcept {
+    return true;
+  }
+  friend constexpr bool operator!=(const aggregated_fused_launcher &,
+                                   const aggregated_fused_launcher &) noexcept {
+    return false;
+  }
+
+private:
+  template <typename Arguments, size_t... C, size_t... T>
+  static void launch_calls(Arguments &arguments, std::index_sequence<C...>,
+                           std::index_sequence<T...>) {
+    (std::apply(
+         [&arguments](auto &f, auto &...call_args) {
+           std::invoke(f, call_args...,
+                       std::get<number_calls + T>(arguments)...);
+         },
+         std::get<C>(arguments)),
+     ...);
+  }
+};
+
+/// Part of an aggregated copy as declared by one slice
+struct aggregated_copy_segment {
+  char *dst;
+  const char *src;
+  size_t bytes;
+};
+
+/// Default copy function of aggregated copies (host to host)
+struct host_copy_function {
+  void operator()(void *dst, const void *src, const size_t bytes) const {
+    std::memcpy(dst, src, bytes);
+  }
+};
+
+/// Merges the copy segments into as few transfers as possible (segments
+/// that are contiguous in both source and destination become one transfer)
+inline std::vector<aggregated_copy_segment>
+coalesce_copy_segments(std::vector<aggregated_copy_segment> segments) {
+  std::sort(segments.begin(), segments.end(),
+            [](const aggregated_copy_segment &a,
+               const aggregated_copy_segment &b) {
+              return std::less<char *>{}(a.dst, b.dst);
+            });
+  std::vector<aggregated_copy_segment> transfers;
+  for (const auto &segment : segments) {
+    if (segment.bytes == 0)
+      continue;
+    if (!transfers.empty()) {
+      auto &last = transfers.back();
+      if (last.dst + last.bytes == segment.dst &&
+          last.src + last.bytes == segment.src) {
+        last.bytes += segment.bytes;
+        continue;
+      }
+    }
+    transfers.push_back(segment);
+  }
+  return transfers;
+}
+
+/// Launched instead of the per-slice copies of an aggregated copy: issues the
+/// coalesced segments of all slices within the one aggregated launch
+/** copy_function gets called with (dst, src, bytes, ts...) per transfer --
+ * ts being whatever the underlying executor appends to the arguments of its
+ * launches (the stream of a CUDA executor, for instance)
+ */
+template <typename CopyF> struct aggregated_copy_launcher {
+  CopyF copy_function;
+  template <typename... Ts>
+  void operator()(std::vector<aggregated_copy_segment> segments,
+                  Ts &&...ts) const {
+    for (const auto &transfer : coalesce_copy_segments(std::move(segments))) {
+      std::invoke(copy_function, static_cast<void *>(transfer.dst),
+                  static_cast<const void *>(transfer.src), transfer.bytes,
+                  ts...);
+    }
+  }
+};
+
 /// Manages the launch conditions for aggregated function calls
 /// type/value-errors
 /** Launch conditions: All slice executors must have called the same function
@@ -122,7 +454,10 @@ hpx::lcos::future<void> exec_async_wrapper(Executor & exec, F &&f, Ts &&...ts) {
  * match the first one in both types and values (throws exception otherwise)
  */
 
-template <typename Executor> class aggregated_function_call {
+/// Aggregated call of all slices (fixed_slices > 0: compile-time upper bound
+/// of the number of slices, see Aggregated_Executor)
+template <typename Executor, size_t fixed_slices = 0>
+class aggregated_function_call {
 private:
   std::atomic<size_t> slice_counter = 0;
 
@@ -130,9 +465,10 @@ private:
   /* hpx::lcos::local::promise<void> slices_ready_promise; */
   /// Tracks if all slices have visited this function call
   /* hpx::lcos::future<void> all_slices_ready = slices_ready_promise.get_future(); */
-  /// How many slices can we expect?
-  const size_t number_slices;
-  const bool async_mode;
+  /// How many slices can we expect? (a multi-slice arrival counts for all of
+  /// its local slices). Reduced by withdrawn slices.
+  size_t number_slices;
+  bool async_mode;
 
   Executor &underlying_executor;
 
@@ -145,9 +481,175 @@ private:
   /// Stores the string of the first function call for debug output
   std::string debug_type_information;
   aggregation_mutex_t debug_mut;
+  /// Disabled for calls replayed from a recorded launch plan
+  bool validate_call_arguments{true};
+#endif
+
+  slice_storage_t<hpx::lcos::local::promise<void>, fixed_slices>
+      potential_async_promises{};
+
+  /// Sets all potential_async_promises (unrolled for a compile-time number of
+  /// slices)
+  void set_async_promises(void) {
+    // Take the promises first: The woken up slices may finish their round
+    // (and this call may be destroyed or reused) before we are done here
+    auto promises = std::move(potential_async_promises);
+    if constexpr (fixed_slices == 0) {
+      for (auto &promise : promises) {
+        promise.set_value();
+      }
+    } else {
+      set_async_promises_unrolled(promises,
+                                  std::make_index_sequence<fixed_slices>{});
+    }
+  }
+  template <size_t... I>
+  static void set_async_promises_unrolled(
+      slice_storage_t<hpx::lcos::local::promise<void>, fixed_slices> &promises,
+      std::index_sequence<I...>) {
+    const size_t number_promises = promises.size();
+    ((I < number_promises ? promises[I].set_value() : void()), ...);
+  }
+
+  /// Launches this call with the arguments of its first slice -- only
+  /// required if slice withdrawals complete the call (all remaining slices
+  /// have already visited it). Stays empty for sync_aggregation_slices points.
+  std::function<void()> withdrawal_launcher;
+
+  /// Moves (or references, depending on how they were passed to the call)
+  /// the call arguments of the first slice into the withdrawal_launcher --
+  /// launch gets invoked with lvalues of the stored function and arguments.
+  /// Only for slices that do not launch the call themselves (their arguments
+  /// are not needed otherwise). F and Ts need to be given explicitly (the
+  /// types of the original call)
+  template <typename F, typename... Ts, typename Launch>
+  void store_withdrawal_launcher(Launch &&launch, std::remove_reference_t<F> &f,
+                                 std::remove_reference_t<Ts> &...ts) {
+    using call_tuple_t = std::tuple<F, Ts...>;
+    static_assert(std::is_move_constructible_v<call_tuple_t>,
+                  "Aggregated calls require movable arguments");
+    // shared_ptr: std::function requires a copyable launcher, the arguments
+    // may be move-only
+    withdrawal_launcher = [launch, call = std::make_shared<call_tuple_t>(
+                                       std::forward<F>(f),
+                                       std::forward<Ts>(ts)...)]() mutable {
+      std::apply(launch, *call);
+    };
+  }
+
+#if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
+  /// Stores the call of the first slice -- or checks if both the type and the
+  /// values of the current call match the stored one. F and Ts need to be
+  /// given explicitly (the types of the call)
+  template <typename F, typename... Ts>
+  void check_call_arguments(const size_t local_counter,
+                            const std::string &call_type,
+                            std::remove_reference_t<F> &f,
+                            std::remove_reference_t<Ts> &...ts) {
+    using call_tuple_t = std::tuple<std::remove_reference_t<F> &, Ts...>;
+    if constexpr (!std::is_copy_constructible_v<call_tuple_t>) {
+      // Move-only arguments cannot be kept for comparison: only check types
+      if (local_counter == 0) {
+        debug_type_information = typeid(call_tuple_t).name();
+      } else if (debug_type_information != typeid(call_tuple_t).name()) {
+        hpx::cout << "\nMismatched types error in aggregated " << call_type
+                  << " call of executor\n"
+                  << "Expected types:\t\t "
+                  << boost::core::demangle(debug_type_information.c_str())
+                  << "\nGot types:\t\t "
+                  << boost::core::demangle(typeid(call_tuple_t).name())
+                  << "\n"
+                  << std::endl;
+      }
+    } else {
+      // Copies rvalue arguments -- they are still required for the launch
+      auto call_tuple = std::tuple<std::remove_reference_t<F> &, Ts...>(f, ts...);
+      if (local_counter == 0) {
+        function_tuple = call_tuple;
+        debug_type_information = typeid(decltype(call_tuple)).name();
+        return;
+      }
+      try {
+        auto orig_call_tuple =
+            std::any_cast<decltype(call_tuple)>(function_tuple);
+        if constexpr (call_values_comparable<decltype(call_tuple)>::value) {
+          if (call_tuple != orig_call_tuple) {
+            throw std::runtime_error("Values of " + call_type +
+                                     " function arguments (or function "
+                                     "itself) do not match ");
+          }
+        }
+      } catch (const std::bad_any_cast &e) {
+        hpx::cout << "\nMismatched types error in aggregated " << call_type
+                  << " call of executor "
+                  << ": " << e.what() << "\n";
+        hpx::cout << "Expected types:\t\t "
+                  << boost::core::demangle(debug_type_information.c_str());
+        hpx::cout << "\nGot types:\t\t "
+                  << boost::core::demangle(typeid(decltype(call_tuple)).name())
+                  << "\n"
+                  << std::endl;
+        // throw;
+      } catch (const std::runtime_error &e) {
+        hpx::cout << "\nMismatched values error in aggregated " << call_type
+                  << " call of executor "
+                  << ": " << e.what() << std::endl;
+        hpx::cout << "Types (matched):\t "
+                  << boost::core::demangle(debug_type_information.c_str());
+        auto orig_call_tuple =
+            std::any_cast<decltype(call_tuple)>(function_tuple);
+        hpx::cout << "\nExpected values:\t ";
+        print_tuple(orig_call_tuple);
+        hpx::cout << "\nGot values:\t\t ";
+        print_tuple(call_tuple);
+        hpx::cout << std::endl << std::endl;
+        // throw;
+      }
+    }
+  }
 #endif
 
-  std::vector<hpx::lcos::local::promise<void>> potential_async_promises{};
+  /// Segments of an aggregated copy (one per slice, see copy_when)
+  std::vector<aggregated_copy_segment> copy_segments{};
+  /// Issues the copy segments collected so far with one aggregated launch
+  template <typename Launcher> void launch_copy(const Launcher &launcher) {
+    auto fut = exec_async_wrapper<Executor>(underlying_executor, launcher,
+                                            std::move(copy_segments));
+    fut.then([this](auto &&fut) { set_async_promises(); });
+  }
+
+  /// Parts of an aggregated bulk call (one per slice arrival, see bulk_when)
+  std::vector<std::shared_ptr<aggregated_bulk_part>> bulk_parts{};
+  /// Runs the bulk parts collected so far with one aggregated launch
+  void launch_bulk(void) {
+    auto fut = exec_async_wrapper<Executor>(
+        underlying_executor, aggregated_bulk_launcher{}, std::move(bulk_parts));
+    fut.then([this](auto &&fut) { set_async_promises(); });
+  }
+
+  /// Completion callbacks of the slices that used then_when (called once the
+  /// aggregated launch is done, with the exception of the launch if any)
+  std::vector<std::function<void(std::exception_ptr)>> completion_callbacks{};
+  /// Launches the call and notifies all completion_callbacks when it is done
+  template <typename F, typename... Ts>
+  void launch_and_notify(F &&f, Ts &&...ts) {
+    auto fut = exec_async_wrapper<Executor, F, Ts...>(
+        underlying_executor, std::forward<F>(f), std::forward<Ts>(ts)...);
+    // The callbacks may complete the last slice (and thus destroy this call),
+    // a reuse may clear them: The continuation owns them instead
+    fut.then([callbacks = std::move(completion_callbacks)](auto &&fut) {
+      std::exception_ptr launch_exception{};
+      try {
+        fut.get();
+      } catch (...) {
+        launch_exception = std::current_exception();
+      }
+      for (auto &callback : callbacks) {
+        callback(launch_exception);
+      }
+    });
+    completion_callbacks.clear();
+  }
 
 public:
   aggregated_function_call(const size_t number_slices, bool async_mode, Executor &exec)
@@ -155,23 +657,49 @@ public:
     if (async_mode)
       potential_async_promises.resize(number_slices);
   }
+  /// Prepares this (completed) call for the next aggregation round instead of
+  /// creating a new one -- used by the launch plans of Aggregated_Executor.
+  /// Returns false if the call type does not match the recorded one
+  bool reuse(const size_t new_number_slices, const bool new_async_mode,
+             const bool validate_arguments) {
+    assert(slice_counter == number_slices);
+    if (new_async_mode != async_mode)
+      return false;
+    slice_counter = 0;
+    number_slices = new_number_slices;
+    potential_async_promises.clear();
+    if (async_mode)
+      potential_async_promises.resize(number_slices);
+    withdrawal_launcher = nullptr;
+    copy_segments.clear();
+    bulk_parts.clear();
+    completion_callbacks.clear();
+#if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
+    function_tuple.reset();
+    debug_type_information.clear();
+    validate_call_arguments = validate_arguments;
+#endif
+    return true;
+  }
   ~aggregated_function_call(void) {
     // All slices should have done this call
     assert(slice_counter == number_slices);
     // assert(!all_slices_ready.valid());
   }
   /// Returns true if all required slices have visited this point
-  bool sync_aggregation_slices(hpx::lcos::future<void> &stream_future) {
+  bool sync_aggregation_slices(hpx::lcos::future<void> &stream_future,
+                               const size_t number_local_slices) {
     assert(!async_mode);
     assert(potential_async_promises.empty());
-    const size_t local_counter = slice_counter++;
-    if (local_counter == number_slices - 1) {
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
+    if (local_counter + number_local_slices == number_slices) {
       return true;
     }
     else return false;
   }
   template <typename F, typename... Ts>
-  void post_when(hpx::lcos::future<void> &stream_future, F &&f, Ts &&...ts) {
+  void post_when(hpx::lcos::future<void> &stream_future,
+                 const size_t number_local_slices, F &&f, Ts &&...ts) {
 #if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
     // needed for concurrent access to function_tuple and debug_type_information
     // Not required for normal use
@@ -179,73 +707,34 @@ public:
 #endif
     assert(!async_mode);
     assert(potential_async_promises.empty());
-    const size_t local_counter = slice_counter++;
-
-    if (local_counter == 0) {
-#if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
-      auto tmp_tuple =
-          make_tuple_supporting_references(f, std::forward<Ts>(ts)...);
-      function_tuple = tmp_tuple;
-      debug_type_information = typeid(decltype(tmp_tuple)).name();
-#endif
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
 
-    } else {
-      //
-      // This scope checks if both the type and the values of the current call
-      // match the original call To be used in debug build...
-      //
 #if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
-      auto comparison_tuple =
-          make_tuple_supporting_references(f, std::forward<Ts>(ts)...);
-      try {
-        auto orig_call_tuple =
-            std::any_cast<decltype(comparison_tuple)>(function_tuple);
-        if (comparison_tuple != orig_call_tuple) {
-          throw std::runtime_error(
-              "Values of post function arguments (or function "
-              "itself) do not match ");
-        }
-      } catch (const std::bad_any_cast &e) {
-        hpx::cout
-            << "\nMismatched types error in aggregated post call of executor "
-            << ": " << e.what() << "\n";
-        hpx::cout << "Expected types:\t\t "
-                  << boost::core::demangle(debug_type_information.c_str());
-        hpx::cout << "\nGot types:\t\t "
-                  << boost::core::demangle(
-                         typeid(decltype(comparison_tuple)).name())
-                  << "\n"
-                  << std::endl;
-        // throw;
-      } catch (const std::runtime_error &e) {
-        hpx::cout
-            << "\nMismatched values error in aggregated post call of executor "
-            << ": " << e.what() << std::endl;
-        hpx::cout << "Types (matched):\t "
-                  << boost::core::demangle(debug_type_information.c_str());
-        auto orig_call_tuple =
-            std::any_cast<decltype(comparison_tuple)>(function_tuple);
-        hpx::cout << "\nExpected values:\t ";
-        print_tuple(orig_call_tuple);
-        hpx::cout << "\nGot values:\t\t ";
-        print_tuple(comparison_tuple);
-        hpx::cout << std::endl << std::endl;
-        // throw;
-      }
+    if (validate_call_arguments)
+      check_call_arguments<F, Ts...>(local_counter, "post", f, ts...);
 #endif
+    if (local_counter == 0 && number_local_slices < number_slices) {
+      store_withdrawal_launcher<F, Ts...>(
+          [this](auto &func, auto &...args) {
+            exec_post_wrapper<Executor, F, Ts...>(underlying_executor,
+                                                  std::forward<F>(func),
+                                                  std::forward<Ts>(args)...);
+          },
+          f, ts...);
     }
-    assert(local_counter < number_slices);
+    assert(local_counter + number_local_slices <= number_slices);
     assert(slice_counter < number_slices + 1);
     // Check exit criteria: Launch function call continuation by setting the
     // slices promise
-    if (local_counter == number_slices - 1) {
+    if (local_counter + number_local_slices == number_slices) {
       exec_post_wrapper<Executor, F, Ts...>(underlying_executor, std::forward<F>(f), std::forward<Ts>(ts)...);
       //slices_ready_promise.set_value();
     }
   }
   template <typename F, typename... Ts>
   hpx::lcos::future<void> async_when(hpx::lcos::future<void> &stream_future,
-                                     F &&f, Ts &&...ts) {
+                                     const size_t number_local_slices, F &&f,
+                                     Ts &&...ts) {
 #if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
     // needed for concurrent access to function_tuple and debug_type_information
     // Not required for normal use
@@ -253,72 +742,30 @@ public:
 #endif
     assert(async_mode);
     assert(!potential_async_promises.empty());
-    const size_t local_counter = slice_counter++;
-    if (local_counter == 0) {
-#if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
-      auto tmp_tuple =
-          make_tuple_supporting_references(f, std::forward<Ts>(ts)...);
-      function_tuple = tmp_tuple;
-      debug_type_information = typeid(decltype(tmp_tuple)).name();
-#endif
-    } else {
-      //
-      // This scope checks if both the type and the values of the current call
-      // match the original call To be used in debug build...
-      //
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
 #if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
-      auto comparison_tuple =
-          make_tuple_supporting_references(f, std::forward<Ts>(ts)...);
-      try {
-        auto orig_call_tuple =
-            std::any_cast<decltype(comparison_tuple)>(function_tuple);
-        if (comparison_tuple != orig_call_tuple) {
-          throw std::runtime_error(
-              "Values of async function arguments (or function "
-              "itself) do not match ");
-        }
-      } catch (const std::bad_any_cast &e) {
-        hpx::cout
-            << "\nMismatched types error in aggregated async call of executor "
-            << ": " << e.what() << "\n";
-        hpx::cout << "Expected types:\t\t "
-                  << boost::core::demangle(debug_type_information.c_str());
-        hpx::cout << "\nGot types:\t\t "
-                  << boost::core::demangle(
-                         typeid(decltype(comparison_tuple)).name())
-                  << "\n"
-                  << std::endl;
-        // throw;
-      } catch (const std::runtime_error &e) {
-        hpx::cout
-            << "\nMismatched values error in aggregated async call of executor "
-            << ": " << e.what() << std::endl;
-        hpx::cout << "Types (matched):\t "
-                  << boost::core::demangle(debug_type_information.c_str());
-        auto orig_call_tuple =
-            std::any_cast<decltype(comparison_tuple)>(function_tuple);
-        hpx::cout << "\nExpected values:\t ";
-        print_tuple(orig_call_tuple);
-        hpx::cout << "\nGot values:\t\t ";
-        print_tuple(comparison_tuple);
-        hpx::cout << std::endl << std::endl;
-        // throw;
-      }
+    if (validate_call_arguments)
+      check_call_arguments<F, Ts...>(local_counter, "async", f, ts...);
 #endif
+    if (local_counter == 0 && number_local_slices < number_slices) {
+      store_withdrawal_launcher<F, Ts...>(
+          [this](auto &func, auto &...args) {
+            auto fut = exec_async_wrapper<Executor, F, Ts...>(
+                underlying_executor, std::forward<F>(func),
+                std::forward<Ts>(args)...);
+            fut.then([this](auto &&fut) { set_async_promises(); });
+          },
+          f, ts...);
     }
-    assert(local_counter < number_slices);
+    assert(local_counter + number_local_slices <= number_slices);
     assert(slice_counter < number_slices + 1);
     assert(potential_async_promises.size() == number_slices);
     hpx::lcos::future<void> ret_fut =
         potential_async_promises[local_counter].get_future();
-    if (local_counter == number_slices - 1) {
+    if (local_counter + number_local_slices == number_slices) {
       /* slices_ready_promise.set_value(); */
       auto fut = exec_async_wrapper<Executor, F, Ts...>(underlying_executor, std::forward<F>(f), std::forward<Ts>(ts)...);
-      fut.then([this](auto &&fut) {
-        for (auto &promise : potential_async_promises) {
-          promise.set_value();
-        }
-      });
+      fut.then([this](auto &&fut) { set_async_promises(); });
     }
     // Check exit criteria: Launch function call continuation by setting the
     // slices promise
@@ -326,26 +773,138 @@ public:
   }
   template <typename F, typename... Ts>
   hpx::lcos::shared_future<void> wrap_async(hpx::lcos::future<void> &stream_future,
+                                     const size_t number_local_slices,
                                      F &&f, Ts &&...ts) {
     assert(async_mode);
     assert(!potential_async_promises.empty());
-    const size_t local_counter = slice_counter++;
-    assert(local_counter < number_slices);
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
+    assert(local_counter + number_local_slices <= number_slices);
     assert(slice_counter < number_slices + 1);
     assert(potential_async_promises.size() == number_slices);
     hpx::lcos::shared_future<void> ret_fut =
         potential_async_promises[local_counter].get_shared_future();
-    if (local_counter == number_slices - 1) {
+    if (local_counter == 0 && number_local_slices < number_slices) {
+      store_withdrawal_launcher<F, Ts...>(
+          [this](auto &func, auto &...args) {
+            auto fut = func(std::forward<Ts>(args)...);
+            fut.then([this](auto &&fut) { set_async_promises(); });
+          },
+          f, ts...);
+    }
+    if (local_counter + number_local_slices == number_slices) {
       auto fut = f(std::forward<Ts>(ts)...);
       fut.then([this](auto &&fut) {
         // TODO just use one promise
-        for (auto &promise : potential_async_promises) {
-          promise.set_value();
-        }
+        set_async_promises();
       });
     }
     return ret_fut;
   }
+  /// Like async_when, but collects the copy segment of each slice (instead of
+  /// requiring the same arguments) and issues them all at once
+  template <typename CopyF>
+  hpx::lcos::future<void> copy_when(hpx::lcos::future<void> &stream_future,
+                                    const size_t number_local_slices,
+                                    CopyF &&copy_function,
+                                    const aggregated_copy_segment segment) {
+    assert(async_mode);
+    assert(!potential_async_promises.empty());
+    using launcher_t = aggregated_copy_launcher<std::decay_t<CopyF>>;
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
+    copy_segments.push_back(segment);
+    if (local_counter == 0 && number_local_slices < number_slices) {
+      // Withdrawals complete the copy with the segments collected until then
+      withdrawal_launcher = [this, launcher = launcher_t{copy_function}]() {
+        launch_copy(launcher);
+      };
+    }
+    assert(local_counter + number_local_slices <= number_slices);
+    assert(slice_counter < number_slices + 1);
+    assert(potential_async_promises.size() == number_slices);
+    hpx::lcos::future<void> ret_fut =
+        potential_async_promises[local_counter].get_future();
+    if (local_counter + number_local_slices == number_slices) {
+      launch_copy(launcher_t{std::forward<CopyF>(copy_function)});
+    }
+    return ret_fut;
+  }
+  /// Like async_when, but collects the bulk part of each slice (instead of
+  /// requiring the same call) and runs them all within one aggregated launch
+  hpx::lcos::future<void>
+  bulk_when(hpx::lcos::future<void> &stream_future,
+            const size_t number_local_slices,
+            std::shared_ptr<aggregated_bulk_part> part) {
+    assert(async_mode);
+    assert(!potential_async_promises.empty());
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
+    bulk_parts.push_back(std::move(part));
+    if (local_counter == 0 && number_local_slices < number_slices) {
+      // Withdrawals complete the call with the parts collected until then
+      withdrawal_launcher = [this]() { launch_bulk(); };
+    }
+    assert(local_counter + number_local_slices <= number_slices);
+    assert(slice_counter < number_slices + 1);
+    assert(potential_async_promises.size() == number_slices);
+    hpx::lcos::future<void> ret_fut =
+        potential_async_promises[local_counter].get_future();
+    if (local_counter + number_local_slices == number_slices) {
+      launch_bulk();
+    }
+    return ret_fut;
+  }
+  /// Like async_when, but notifies the slice through on_completion instead of
+  /// a future (no shared state per slice) -- used by the sender interface
+  template <typename F, typename... Ts>
+  void then_when(hpx::lcos::future<void> &stream_future,
+                 const size_t number_local_slices,
+                 std::function<void(std::exception_ptr)> &&on_completion,
+                 F &&f, Ts &&...ts) {
+#if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
+    // needed for concurrent access to function_tuple and debug_type_information
+    // Not required for normal use
+    std::lock_guard<aggregation_mutex_t> guard(debug_mut);
+#endif
+    assert(!async_mode);
+    assert(potential_async_promises.empty());
+    const size_t local_counter = slice_counter.fetch_add(number_local_slices);
+    completion_callbacks.emplace_back(std::move(on_completion));
+#if !(defined(NDEBUG)) && defined(DEBUG_AGGREGATION_CALLS)
+    if (validate_call_arguments)
+      check_call_arguments<F, Ts...>(local_counter, "then", f, ts...);
+#endif
+    if (local_counter == 0 && number_local_slices < number_slices) {
+      store_withdrawal_launcher<F, Ts...>(
+          [this](auto &func, auto &...args) {
+            launch_and_notify<F, Ts...>(std::forward<F>(func),
+                                        std::forward<Ts>(args)...);
+          },
+          f, ts...);
+    }
+    assert(local_counter + number_local_slices <= number_slices);
+    assert(slice_counter < number_slices + 1);
+    if (local_counter + number_local_slices == number_slices) {
+      launch_and_notify<F, Ts...>(std::forward<F>(f), std::forward<Ts>(ts)...);
+    }
+  }
+  /// Removes withdrawn slices from the expected arrivals. Launches the call in
+  /// case all remaining slices have already visited it
+  void withdraw_slices(const size_t number_withdrawn_slices) {
+    assert(number_withdrawn_slices <= number_slices - slice_counter);
+    number_slices -= number_withdrawn_slices;
+    // The promises of the withdrawn slices were never handed out (slices get
+    // the promises in order of arrival)
+    while (potential_async_promises.size() > number_slices)
+      potential_async_promises.pop_back();
+    if (slice_counter == number_slices) {
+      // withdrawal completed the call
+      if (!withdrawal_launcher) {
+        throw std::runtime_error(
+            "Executor slice withdrawn while other slices wait at a "
+            "sync_aggregation_slices point it did not reach");
+      }
+      withdrawal_launcher();
+    }
+  }
   // We need to be able to copy or no-except move for std::vector..
   aggregated_function_call(const aggregated_function_call &other) = default;
   aggregated_function_call &
@@ -360,16 +919,28 @@ public:
 
 enum class Aggregated_Executor_Modes { EAGER = 1, STRICT, ENDLESS };
 /// Declaration since the actual allocator is only defined after the Executors
-template <typename T, typename Host_Allocator, typename Executor>
+template <typename T, typename Host_Allocator, typename Executor,
+          size_t fixed_slices = 0>
 class Allocator_Slice;
+#if defined(CPPUDDLE_HAVE_AGGREGATION_SENDERS)
+/// Declaration since the senders are only defined after the Executors
+template <typename Slice> struct aggregated_schedule_sender;
+#endif
 
 /// Executor Class that aggregates function calls for specific kernels
 /** Executor is not meant to be used directly. Instead it yields multiple
  * Executor_Slice objects. These serve as interfaces. Slices from the same
  * Aggregated_Executor are meant to execute the same function calls but on
  * different data (i.e. different tasks)
+ *
+ * fixed_slices > 0 makes the maximum number of slices a compile-time
+ * constant: The per-slice storage (slice promises, promises of the async
+ * calls) then lives inline instead of on the heap and the promise fan-out is
+ * unrolled. max_slices may not exceed fixed_slices in that case (and the
+ * unbounded ENDLESS mode is not supported).
  */
-template <typename Executor> class Aggregated_Executor {
+template <typename Executor, size_t fixed_slices = 0>
+class Aggregated_Executor {
 private:
   //===============================================================================
   // Misc private avariables:
@@ -377,8 +948,6 @@ private:
   std::atomic<bool> slices_exhausted;
 
   std::atomic<bool> executor_slices_alive;
-  std::atomic<bool> buffers_in_use;
-  std::atomic<size_t> dealloc_counter;
 
   const Aggregated_Executor_Modes mode;
   const size_t max_slices;
@@ -387,32 +956,63 @@ private:
   std::tuple<Executor &, size_t> executor_tuple;
   /// Reference to the executor (presumably residing in the executor pool)
   Executor &executor;
+  /// Recycler location used for the aggregated buffers. Each aggregation
+  /// executor gets its own stable location (derived from its position in the
+  /// aggregation pool or from the ID of the underlying executor) to avoid all
+  /// executors contending on the same recycler lock
+  const size_t buffer_location;
 
 public:
   // Subclasses
 
+  /// Maximum number of dependency groups (see Executor_Slice::post_in_group)
+  static constexpr size_t max_dependency_groups = 8;
+  /// Position of a call within the calls of a slice: Calls are matched with
+  /// the calls of the other slices by their index in their dependency group
+  struct call_position {
+    size_t dependency_group;
+    size_t group_call_index;
+  };
+
   /// Slice class - meant as a scope interface to the aggregated executor
+  /** A slice may stand for multiple consecutive slices (see
+   * request_executor_slices): It then owns the slice ids [id, id +
+   * number_local_slices) and each of its function calls and buffer requests
+   * counts for all of them.
+   */
   class Executor_Slice {
   public:
-    Aggregated_Executor<Executor> &parent;
+    Aggregated_Executor &parent;
   private:
     /// Executor is a slice of this aggregated_executor
     /// How many functions have been called - required to enforce sequential
     /// behaviour of kernel launches
     size_t launch_counter{0};
+    /// How many functions have been called per dependency group (the calls
+    /// of the slices are matched per group)
+    std::array<size_t, max_dependency_groups> group_launch_counters{};
     size_t buffer_counter{0};
     bool notify_parent_about_destruction{true};
+    /// Slice does not take part in any further function calls
+    bool withdrawn{false};
 
   public:
     /// How many slices are there overall - required to check the launch
     /// criteria
     const size_t number_slices;
     const size_t id;
+    /// How many of the number_slices slices are handled by this slice
+    const size_t number_local_slices;
     using executor_t = Executor;
+    /// Required for the executor traits of the slices (see the end of this
+    /// file)
+    using aggregated_executor_t = Aggregated_Executor;
     Executor_Slice(Aggregated_Executor &parent, const size_t slice_id,
-                   const size_t number_slices)
+                   const size_t number_slices,
+                   const size_t number_local_slices = 1)
         : parent(parent), notify_parent_about_destruction(true),
-          number_slices(number_slices), id(slice_id) {
+          number_slices(number_slices), id(slice_id),
+          number_local_slices(number_local_slices) {
   }
     ~Executor_Slice(void) {
       // Don't notify parent if we moved away from this executor_slice
@@ -423,55 +1023,246 @@ public:
         // parent still in execution mode?
         assert(parent.slices_exhausted == true);
         // all kernel launches done?
-        assert(launch_counter == parent.function_calls.size());
+        assert(withdrawn || launch_counter == parent.overall_launch_counter);
         // Notifiy parent that this aggregation slice is one
-        parent.reduce_usage_counter();
+        parent.reduce_usage_counter(number_local_slices);
       }
     }
     Executor_Slice(const Executor_Slice &other) = delete;
     Executor_Slice &operator=(const Executor_Slice &other) = delete;
     Executor_Slice(Executor_Slice &&other)
         : parent(other.parent), launch_counter(std::move(other.launch_counter)),
+          group_launch_counters(std::move(other.group_launch_counters)),
           buffer_counter(std::move(other.buffer_counter)),
+          withdrawn(std::move(other.withdrawn)),
           number_slices(std::move(other.number_slices)),
-          id(std::move(other.id)) {
+          id(std::move(other.id)),
+          number_local_slices(std::move(other.number_local_slices)) {
       other.notify_parent_about_destruction = false;
     }
     Executor_Slice &operator=(Executor_Slice &&other) {
       parent = other.parent;
       launch_counter = std::move(other.launch_counter);
+      group_launch_counters = std::move(other.group_launch_counters);
       buffer_counter = std::move(other.buffer_counter);
+      withdrawn = std::move(other.withdrawn);
       number_slices = std::move(other.number_slices);
       id = std::move(other.id);
+      number_local_slices = std::move(other.number_local_slices);
       other.notify_parent_about_destruction = false;
     }
     template <typename T, typename Host_Allocator>
-    Allocator_Slice<T, Host_Allocator, Executor> make_allocator() {
-      return Allocator_Slice<T, Host_Allocator, Executor>(*this);
+    Allocator_Slice<T, Host_Allocator, Executor, fixed_slices>
+    make_allocator() {
+      return Allocator_Slice<T, Host_Allocator, Executor, fixed_slices>(
+          *this);
+    }
+  private:
+    /// Position of the next call of this slice in the given dependency group
+    call_position next_call(const size_t dependency_group) {
+      assert(dependency_group < max_dependency_groups);
+      launch_counter++;
+      return call_position{dependency_group,
+                           group_launch_counters[dependency_group]++};
     }
+
+  public:
     bool sync_aggregation_slices() {
       assert(parent.slices_exhausted == true);
-      auto ret = parent.sync_aggregation_slices(launch_counter);
-      launch_counter++;
-      return ret;
+      assert(!withdrawn);
+      return parent.sync_aggregation_slices(next_call(0), number_local_slices);
     }
     template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+      post_in_group(0, std::forward<F>(f), std::forward<Ts>(ts)...);
+    }
+    template <typename F, typename... Ts>
+    hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+      return async_in_group(0, std::forward<F>(f), std::forward<Ts>(ts)...);
+    }
+    /// Like post, but the call only keeps its order relative to the other
+    /// calls of the same dependency group
+    /** The calls of the slices are matched per dependency group (the n-th
+     * call of a group of one slice is aggregated with the n-th call of this
+     * group of the other slices) -- independent calls in different groups
+     * may thus be issued in a different order by each slice and launch as
+     * soon as all slices reached them. Calls without a group belong to
+     * group 0. All groups still share the underlying executor.
+     */
+    template <typename F, typename... Ts>
+    void post_in_group(const size_t dependency_group, F &&f, Ts &&...ts) {
       // we should only execute function calls once all slices
       // have been given away (-> Executor Slices start)
       assert(parent.slices_exhausted == true);
-      parent.post(launch_counter, std::forward<F>(f), std::forward<Ts>(ts)...);
-      launch_counter++;
+      assert(!withdrawn);
+      parent.post(next_call(dependency_group), number_local_slices,
+                  std::forward<F>(f), std::forward<Ts>(ts)...);
     }
+    /// Like async, but the call only keeps its order relative to the other
+    /// calls of the same dependency group (see post_in_group)
     template <typename F, typename... Ts>
-    hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+    hpx::lcos::future<void> async_in_group(const size_t dependency_group,
+                                           F &&f, Ts &&...ts) {
       // we should only execute function calls once all slices
       // have been given away (-> Executor Slices start)
       assert(parent.slices_exhausted == true);
-      hpx::lcos::future<void> ret_fut = parent.async(
-          launch_counter, std::forward<F>(f), std::forward<Ts>(ts)...);
-      launch_counter++;
-      return ret_fut;
+      assert(!withdrawn);
+      return parent.async(next_call(dependency_group), number_local_slices,
+                          std::forward<F>(f), std::forward<Ts>(ts)...);
+    }
+    /// Aggregated bulk call: f(element, ts...) gets called for all elements
+    /// of shape within one aggregated launch. Unlike with async, each slice
+    /// may use its own callable, shape and arguments (e.g. the chunks of a
+    /// parallel algorithm over its own data): The bulk parts of all slices
+    /// are merged into the launch. Identical calls of all slices (same
+    /// comparable callable, shape and arguments -- e.g. over the aggregated
+    /// buffers) run only once.
+    /** Returns one future for the whole shape -- or one future per element
+     * if f returns values
+     */
+    template <typename F, typename Shape, typename... Ts>
+    auto bulk_async(F &&f, const Shape &shape, Ts &&...ts) {
+      using result_t =
+          std::invoke_result_t<std::decay_t<F> &, decltype(*std::begin(shape)),
+                               std::decay_t<Ts> &...>;
+      assert(parent.slices_exhausted == true);
+      assert(!withdrawn);
+      // Copy the call -- the aggregated launch may happen after this call
+      // returned
+      auto part = std::make_shared<aggregated_bulk_call<
+          result_t, std::decay_t<F>, Shape, std::decay_t<Ts>...>>(
+          std::forward<F>(f), shape, std::forward<Ts>(ts)...);
+      if constexpr (std::is_void_v<result_t>) {
+        return parent.aggregated_bulk(next_call(0), number_local_slices,
+                                      std::move(part));
+      } else {
+        auto results = part->get_results();
+        parent.aggregated_bulk(next_call(0), number_local_slices, part)
+            .then([part](auto &&fut) {
+              std::exception_ptr launch_exception{};
+              try {
+                fut.get();
+              } catch (...) {
+                launch_exception = std::current_exception();
+              }
+              part->publish_results(launch_exception);
+            });
+        return results;
+      }
+    }
+    /// Fused aggregated call: Each call is a tuple of a kernel and its
+    /// arguments (see make_tuple_supporting_references). All calls run back
+    /// to back within one aggregated launch, replacing one launch per kernel.
+    /// Usually used with a composite_kernel_pool.
+    template <typename... Calls>
+    hpx::lcos::future<void> fused_async(Calls &&...calls) {
+      static_assert(sizeof...(Calls) > 0, "Fused calls require a kernel");
+      return async(aggregated_fused_launcher<sizeof...(Calls)>{},
+                   std::forward<Calls>(calls)...);
     }
+    template <typename... Calls> void fused_post(Calls &&...calls) {
+      static_assert(sizeof...(Calls) > 0, "Fused calls require a kernel");
+      post(aggregated_fused_launcher<sizeof...(Calls)>{},
+           std::forward<Calls>(calls)...);
+    }
+    /// Aggregated copy: Each slice declares its part (bytes from src to dst
+    /// + dst_offset). Once all slices arrived, the parts get coalesced into
+    /// as few contiguous transfers as possible, which are issued with
+    /// copy_function within one aggregated launch (see
+    /// aggregated_copy_launcher). All slices need to use the same dst buffer
+    /// and copy_function -- the ones of the first slice are used.
+    template <typename CopyF>
+    hpx::lcos::future<void> aggregated_copy(CopyF &&copy_function, void *dst,
+                                            const void *src,
+                                            const size_t dst_offset,
+                                            const size_t bytes) {
+      assert(parent.slices_exhausted == true);
+      assert(!withdrawn);
+      return parent.aggregated_copy(
+          next_call(0), number_local_slices,
+          std::forward<CopyF>(copy_function),
+          aggregated_copy_segment{static_cast<char *>(dst) + dst_offset,
+                                  static_cast<const char *>(src), bytes});
+    }
+    /// Aggregated host copy (memcpy)
+    hpx::lcos::future<void> aggregated_copy(void *dst, const void *src,
+                                            const size_t dst_offset,
+                                            const size_t bytes) {
+      return aggregated_copy(host_copy_function{}, dst, src, dst_offset,
+                             bytes);
+    }
+    /// Like async, but calls on_completion (with the exception of the
+    /// aggregated launch, if any) instead of returning a future
+    template <typename F, typename... Ts>
+    void async_notify(std::function<void(std::exception_ptr)> on_completion,
+                      F &&f, Ts &&...ts) {
+      assert(parent.slices_exhausted == true);
+      assert(!withdrawn);
+      // Increment first: on_completion may already continue with the next
+      // call of this slice before parent.async_notify returns
+      parent.async_notify(next_call(0), number_local_slices,
+                          std::move(on_completion), std::forward<F>(f),
+                          std::forward<Ts>(ts)...);
+    }
+
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+    /// Awaitable of an aggregated function call (see co_async)
+    template <typename F, typename... Ts> class aggregated_call_awaitable {
+    private:
+      Executor_Slice &slice;
+      /// The arguments stay in the coroutine frame until the completion
+      std::tuple<F, Ts...> call;
+      std::exception_ptr launch_exception{};
+      std::coroutine_handle<> awaiting_coroutine{};
+      /// Set by both the suspension and the completion -- whichever comes
+      /// second continues the coroutine
+      std::atomic<bool> suspended_or_completed{false};
+
+    public:
+      aggregated_call_awaitable(Executor_Slice &slice,
+                                std::tuple<F, Ts...> &&call)
+          : slice(slice), call(std::move(call)) {}
+      bool await_ready() const noexcept { return false; }
+      bool await_suspend(std::coroutine_handle<> coroutine) {
+        awaiting_coroutine = coroutine;
+        std::apply(
+            [this](auto &f, auto &...ts) {
+              slice.async_notify(
+                  [this](std::exception_ptr exception) {
+                    launch_exception = exception;
+                    if (suspended_or_completed.exchange(true))
+                      awaiting_coroutine.resume();
+                  },
+                  f, ts...);
+            },
+            call);
+        // Already completed? Then continue without suspending
+        return !suspended_or_completed.exchange(true);
+      }
+      void await_resume() {
+        if (launch_exception)
+          std::rethrow_exception(launch_exception);
+      }
+    };
+    /// Coroutine version of async: co_await slice.co_async(f, ts...) resumes
+    /// the coroutine directly once the aggregated launch is done (no future
+    /// involved). Arguments are copied into the awaitable.
+    template <typename F, typename... Ts>
+    aggregated_call_awaitable<std::decay_t<F>, std::decay_t<Ts>...>
+    co_async(F &&f, Ts &&...ts) {
+      return aggregated_call_awaitable<std::decay_t<F>, std::decay_t<Ts>...>(
+          *this, {std::forward<F>(f), std::forward<Ts>(ts)...});
+    }
+#endif
+
+#if defined(CPPUDDLE_HAVE_AGGREGATION_SENDERS)
+    /// Sender interface: schedule(slice) starts a pipeline of aggregated
+    /// stages (see aggregated_then and aggregated_bulk)
+    friend aggregated_schedule_sender<Executor_Slice>
+    tag_invoke(hpx::execution::experimental::schedule_t,
+               Executor_Slice &slice) {
+      return aggregated_schedule_sender<Executor_Slice>{&slice};
+    }
+#endif
 
     // OneWay Execution
     template <typename F, typename... Ts>
@@ -491,28 +1282,90 @@ public:
             std::forward<F>(f), std::forward<Ts>(ts)...);
     }
 
+    // BulkTwoWay Execution (one aggregated launch for the whole shape)
+    template <typename F, typename Shape, typename... Ts>
+    friend auto tag_invoke(hpx::parallel::execution::bulk_async_execute_t,
+                           Executor_Slice &exec, F &&f, const Shape &shape,
+                           Ts &&...ts) {
+      auto fut =
+          exec.bulk_async(std::forward<F>(f), shape, std::forward<Ts>(ts)...);
+      if constexpr (std::is_same_v<decltype(fut),
+                                   hpx::lcos::future<void>>) {
+        std::vector<hpx::lcos::future<void>> results;
+        results.push_back(std::move(fut));
+        return results;
+      } else {
+        return fut;
+      }
+    }
+
+    // BulkOneWay Execution (synchronous)
+    template <typename F, typename Shape, typename... Ts>
+    friend auto tag_invoke(hpx::parallel::execution::bulk_sync_execute_t,
+                           Executor_Slice &exec, F &&f, const Shape &shape,
+                           Ts &&...ts) {
+      auto fut =
+          exec.bulk_async(std::forward<F>(f), shape, std::forward<Ts>(ts)...);
+      if constexpr (std::is_same_v<decltype(fut),
+                                   hpx::lcos::future<void>>) {
+        fut.get();
+      } else {
+        using result_t = decltype(fut.front().get());
+        std::vector<result_t> results;
+        results.reserve(fut.size());
+        for (auto &element_fut : fut)
+          results.push_back(element_fut.get());
+        return results;
+      }
+    }
+
     template <typename F, typename... Ts>
     hpx::lcos::shared_future<void> wrap_async(F &&f, Ts &&...ts) {
       // we should only execute function calls once all slices
       // have been given away (-> Executor Slices start)
       assert(parent.slices_exhausted == true);
-      hpx::lcos::shared_future<void> ret_fut = parent.wrap_async(
-          launch_counter, std::forward<F>(f), std::forward<Ts>(ts)...);
-      launch_counter++;
-      return ret_fut;
+      assert(!withdrawn);
+      return parent.wrap_async(next_call(0), number_local_slices,
+                               std::forward<F>(f), std::forward<Ts>(ts)...);
     }
 
     /// Get new aggregated buffer (might have already been allocated been
     /// allocated by different slice)
     template <typename T, typename Host_Allocator> T *get(const size_t size) {
+      size_t ticket_index{};
+      return get<T, Host_Allocator>(size, ticket_index);
+    }
+    /// Same as get, but also returns the ticket index of the buffer (which
+    /// speeds up the pointer lookup in mark_unused)
+    template <typename T, typename Host_Allocator>
+    T *get(const size_t size, size_t &ticket_index) {
       assert(parent.slices_exhausted == true);
+      assert(!withdrawn);
       T *aggregated_buffer =
           parent.get<T, Host_Allocator>(size, buffer_counter);
+      ticket_index = buffer_counter;
       buffer_counter++;
       assert(buffer_counter > 0);
       return aggregated_buffer;
     }
 
+    /// Withdraw this slice from all of its remaining function calls
+    /** For tasks that find out they have nothing (more) to do: The remaining
+     * aggregated function calls only wait for the other slices and get
+     * launched without this one. No further function calls or buffer
+     * requests are allowed afterwards (buffers obtained so far stay valid).
+     * Calls that end up being completed by the withdrawal are launched with
+     * the arguments of their first slice -- references passed to them have to
+     * stay valid until then. Not allowed while other slices wait at a
+     * sync_aggregation_slices point this slice did not reach yet.
+     */
+    void withdraw(void) {
+      assert(parent.slices_exhausted == true);
+      assert(!withdrawn);
+      parent.withdraw(group_launch_counters, number_local_slices);
+      withdrawn = true;
+    }
+
     Executor& get_underlying_executor(void) {
       return parent.executor;
     }
@@ -523,140 +1376,311 @@ public:
   hpx::lcos::local::promise<void> slices_full_promise;
   /// Promises with the slice executors -- to be set when the starting criteria
   /// is met
-  std::vector<hpx::lcos::local::promise<Executor_Slice>> executor_slices;
+  slice_storage_t<hpx::lcos::local::promise<Executor_Slice>, fixed_slices>
+      executor_slices;
+  /// Number of local slices of each of the executor_slices promises
+  slice_storage_t<size_t, fixed_slices> executor_slices_sizes;
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+  /// Coroutine waiting for a slice (instead of a promise) -- resumed with
+  /// the slice emplaced into its awaitable when the starting criteria is met
+  struct slice_awaiting_coroutine {
+    std::coroutine_handle<> coroutine;
+    std::optional<Executor_Slice> *slice;
+    size_t number_local_slices;
+  };
+  slice_storage_t<slice_awaiting_coroutine, fixed_slices> awaiting_coroutines;
+#endif
   /// List of aggregated function calls - function will be launched when all
   /// slices have called it
-  std::deque<aggregated_function_call<Executor>> function_calls;
+  std::deque<aggregated_function_call<Executor, fixed_slices>> function_calls;
   /// For synchronizing the access to the function calls list
   aggregation_mutex_t mut;
-
-  /// Data entry for a buffer allocation: void* pointer, size_t for
-  /// buffer-size, atomic for the slice counter
-  using buffer_entry_t =
-      std::tuple<void*, const size_t, std::atomic<size_t>, bool, const size_t>;
-  /// Keeps track of the aggregated buffer allocations done in all the slices
-  std::deque<buffer_entry_t> buffer_allocations;
-  /// Map pointer to deque index for fast access in the deallocations
-  std::unordered_map<void*,size_t> buffer_allocations_map;
-  /// For synchronizing the access to the buffer_allocations
-  aggregation_mutex_t buffer_mut;
+  /// Number of slices that withdrew from the current aggregation (guarded by
+  /// mut)
+  size_t withdrawn_slices{0};
+  /// Time of the last slice request (guarded by mut)
+  std::chrono::steady_clock::time_point last_slice_request;
+  /// How often did the starvation check launch an incomplete STRICT
+  /// aggregation
+  std::atomic<size_t> forced_launches{0};
+
+  /// Ticket of an aggregated buffer: The n-th buffer request of each slice
+  /// refers to the n-th ticket (lock-free -- the first slice claims the
+  /// ticket and allocates the buffer, the others wait until it is ready)
+  struct buffer_ticket {
+    buffer_ticket() : ready(ready_promise.get_shared_future()) {}
+    std::atomic<int> state{ticket_empty};
+    /// Set by the claiming slice once the ticket is ready -- the other slices
+    /// suspend on ready instead of spinning (both renewed with the reset)
+    hpx::lcos::local::promise<void> ready_promise;
+    hpx::lcos::shared_future<void> ready;
+    /// Only written by the claiming slice (before the ticket is ready)
+    void *buffer{nullptr};
+    size_t size{0};
+    size_t location_id{0};
+    /// Number of slices currently using the buffer
+    std::atomic<size_t> slice_counter{0};
+    /// Still to be given back to the recycler
+    std::atomic<bool> valid{false};
+    /// Buffer goes to the launch plan instead of the recycler once unused
+    bool planned{false};
+    /// Shared by the aggregated views of all slices (see
+    /// aggregated_recycled_view)
+    recycler::detail::view_reference_counter view_references;
+  };
+  static constexpr int ticket_empty = 0;
+  static constexpr int ticket_allocating = 1;
+  static constexpr int ticket_ready = 2;
+  /// Maximum number of aggregated buffers (per slice) in one aggregation
+  static constexpr size_t max_buffer_tickets = 256;
+  /// Preallocated tickets of the aggregated buffers of the current
+  /// aggregation (reset with the first slice request)
+  std::array<buffer_ticket, max_buffer_tickets> buffer_tickets;
+  /// Number of claimed tickets in the current aggregation
   std::atomic<size_t> buffer_counter = 0;
+  /// Number of aggregated buffers not yet given back to the recycler
+  std::atomic<size_t> buffers_in_use = 0;
+
+  //===============================================================================
+  // Launch plans: Record the function calls and aggregated buffers of one
+  // aggregation round and reuse them in the following rounds
+  //
+  enum class launch_plan_state { DISABLED, RECORD_NEXT, RECORDING, RECORDED };
+  /// Changes between rounds only (guarded by mut) -- the buffer functions
+  /// read it lock-free during a round
+  std::atomic<launch_plan_state> plan_state{launch_plan_state::DISABLED};
+  /// Number of slices of the recorded round (guarded by mut)
+  size_t plan_slices{0};
+  /// Current round matches the recorded one: Reused calls skip the argument
+  /// checks (set before the slices get handed out)
+  bool replaying_plan{false};
+  std::atomic<size_t> plan_replays{0};
+  /// Aggregated buffer kept by the launch plan (still marked as used in the
+  /// recycler). The n-th buffer request of a round may reuse the n-th buffer
+  /// if size and type match
+  struct planned_buffer {
+    void *buffer{nullptr};
+    size_t size{0};
+    size_t location_id{0};
+    /// Gives the buffer back to the recycler -- also identifies its type
+    void (*release)(void *, size_t, size_t){nullptr};
+  };
+  std::array<planned_buffer, max_buffer_tickets> plan_buffers;
+
+  template <typename T, typename Host_Allocator>
+  static void release_planned_buffer(void *buffer, const size_t size,
+                                     const size_t location_id) {
+    recycler::detail::buffer_recycler::mark_unused<T, Host_Allocator>(
+        static_cast<T *>(buffer), size, location_id);
+  }
+  /// Gives all buffers of the launch plan back to the recycler -- only
+  /// allowed while no slices and buffers are alive
+  void release_plan_buffers(void) {
+    for (auto &planned : plan_buffers) {
+      if (planned.buffer != nullptr) {
+        planned.release(planned.buffer, planned.size, planned.location_id);
+        planned = planned_buffer{};
+      }
+    }
+  }
+  /// Do unused buffers of the current round go to the launch plan?
+  bool keeps_plan_buffers(void) const {
+    const launch_plan_state state = plan_state.load();
+    return state == launch_plan_state::RECORDING ||
+           state == launch_plan_state::RECORDED;
+  }
+
+  /// Slots (indices into function_calls) of the calls of each dependency
+  /// group in the current round
+  std::array<std::vector<size_t>, max_dependency_groups>
+      dependency_group_calls{};
+  /// Slot of the call at the given position -- adds the call if this is the
+  /// first slice reaching it (only meant to be called with mut locked)
+  size_t get_call_slot(const call_position position, const bool async_mode) {
+    assert(position.dependency_group < max_dependency_groups);
+    auto &group_calls = dependency_group_calls[position.dependency_group];
+    if (position.group_call_index == group_calls.size()) {
+      group_calls.push_back(overall_launch_counter);
+      add_function_call(async_mode);
+    }
+    assert(position.group_call_index < group_calls.size());
+    return group_calls[position.group_call_index];
+  }
+  void clear_dependency_group_calls(void) {
+    for (auto &group_calls : dependency_group_calls)
+      group_calls.clear();
+  }
+
+  /// Adds the next aggregated function call -- reusing the call of the last
+  /// round with the same index if there is one (only meant to be called with
+  /// mut locked)
+  void add_function_call(const bool async_mode) {
+    const size_t number_slices = launched_slices - withdrawn_slices;
+    const size_t call_index = overall_launch_counter;
+    if (call_index < function_calls.size()) {
+      if (function_calls[call_index].reuse(number_slices, async_mode,
+                                           !replaying_plan)) {
+        overall_launch_counter++;
+        return;
+      }
+      // Round deviates from the plan: Drop the remaining calls
+      while (function_calls.size() > call_index)
+        function_calls.pop_back();
+    }
+    function_calls.emplace_back(number_slices, async_mode, executor);
+    overall_launch_counter = function_calls.size();
+  }
 
   /// Get new buffer OR get buffer already allocated by different slice
   template <typename T, typename Host_Allocator>
   T *get(const size_t size, const size_t slice_alloc_counter) {
     assert(slices_exhausted == true);
     assert(executor_slices_alive == true);
-    // Add aggreated buffer entry in case it hasn't happened yet for this call
-    // First: Check if it already has happened
-    if (buffer_counter <= slice_alloc_counter) {
-      // we might be the first! Lock...
-      std::lock_guard<aggregation_mutex_t> guard(buffer_mut);
-      // ... and recheck
-      if (buffer_counter <= slice_alloc_counter) {
-        constexpr bool manage_content_lifetime = false;
-        buffers_in_use = true;
-
-        // Default location -- useful for GPU builds as we otherwise create way too
-        // many different buffers for different aggregation sizes on different GPUs
-        size_t location_id = 0;
+    if (slice_alloc_counter >= max_buffer_tickets) {
+      throw std::runtime_error(
+          "Aggregated_Executor: More than " +
+          std::to_string(max_buffer_tickets) +
+          " aggregated buffers requested within one aggregation");
+    }
+    buffer_ticket &ticket = buffer_tickets[slice_alloc_counter];
+    int expected_state = ticket_empty;
+    // Are we the first slice with this buffer request? Claim the ticket...
+    if (ticket.state.compare_exchange_strong(expected_state,
+                                             ticket_allocating)) {
+      constexpr bool manage_content_lifetime = false;
+      buffers_in_use++;
+      buffer_counter++;
+
+      // Default location -- stable per aggregation executor: still shares the
+      // buffers across all slices (and rounds) of this executor, which is
+      // useful for GPU builds as we otherwise create way too many different
+      // buffers for different aggregation sizes on different GPUs
+      size_t location_id = buffer_location;
 #ifdef CPPUDDLE_HAVE_HPX_AWARE_ALLOCATORS
-        if (max_slices == 1) {
-          // get prefered location: aka the current hpx threads location
-          // Usually handy for CPU builds where we want to use the buffers
-          // close to the current CPU core
-          location_id = hpx::get_worker_thread_num();
-        }
+      if (max_slices == 1) {
+        // get prefered location: aka the current hpx threads location
+        // Usually handy for CPU builds where we want to use the buffers
+        // close to the current CPU core
+        location_id = hpx::get_worker_thread_num();
+      }
 #endif
+      T *aggregated_buffer = nullptr;
+      // Recorded launch plan: Reuse its buffer if it matches this request
+      planned_buffer &planned = plan_buffers[slice_alloc_counter];
+      if (planned.buffer != nullptr && planned.size == size &&
+          planned.release == &release_planned_buffer<T, Host_Allocator>) {
+        aggregated_buffer = static_cast<T *>(planned.buffer);
+        location_id = planned.location_id;
+        planned = planned_buffer{};
+        ticket.planned = true;
+      } else {
         // Get shiny and new buffer that will be shared between all slices
         // Buffer might be recycled from previous allocations by the
         // buffer_recycler...
-        T *aggregated_buffer =
+        aggregated_buffer =
             recycler::detail::buffer_recycler::get<T, Host_Allocator>(
                 size, manage_content_lifetime, location_id);
-        // Create buffer entry for this buffer
-        buffer_allocations.emplace_back(static_cast<void *>(aggregated_buffer),
-                                        size, 1, true, location_id);
-
-#ifndef NDEBUG
-        // if previousely used the buffer should not be in usage anymore
-        const auto exists = buffer_allocations_map.count(
-            static_cast<void *>(aggregated_buffer));
-        if (exists > 0) {
-          const auto previous_usage_id =
-              buffer_allocations_map[static_cast<void *>(aggregated_buffer)];
-          const auto &valid =
-              std::get<3>(buffer_allocations[previous_usage_id]);
-          assert(!valid);
-        }
-#endif
-        buffer_allocations_map.insert_or_assign(static_cast<void *>(aggregated_buffer),
-            buffer_counter);
-
-        assert (buffer_counter == slice_alloc_counter);
-        buffer_counter = buffer_allocations.size();
-
-        // Return buffer
-        return aggregated_buffer;
+        ticket.planned =
+            plan_state.load() == launch_plan_state::RECORDING;
       }
+      // ... fill the ticket and publish it to the other slices
+      ticket.buffer = static_cast<void *>(aggregated_buffer);
+      ticket.size = size;
+      ticket.location_id = location_id;
+      ticket.slice_counter = 1;
+      ticket.valid = true;
+      ticket.state.store(ticket_ready, std::memory_order_release);
+      ticket.ready_promise.set_value();
+      return aggregated_buffer;
     }
-    assert(buffers_in_use == true);
-    assert(std::get<3>(buffer_allocations[slice_alloc_counter])); // valid
-    assert(std::get<2>(buffer_allocations[slice_alloc_counter]) >= 1);
-
-    // Buffer entry should already exist:
-    T *aggregated_buffer = static_cast<T *>(
-        std::get<0>(buffer_allocations[slice_alloc_counter]));
+    // Buffer entry exists (or is about to): Wait for the claiming slice
+    if (ticket.state.load(std::memory_order_acquire) != ticket_ready) {
+      ticket.ready.wait();
+      assert(ticket.state.load(std::memory_order_acquire) == ticket_ready);
+    }
+    assert(buffers_in_use > 0);
+    assert(ticket.valid);
+    assert(ticket.slice_counter >= 1);
     // Error handling: Size is wrong?
-    assert(size == std::get<1>(buffer_allocations[slice_alloc_counter]));
+    assert(size == ticket.size);
     // Notify that one more slice has visited this buffer allocation
-    std::get<2>(buffer_allocations[slice_alloc_counter])++;
-    return aggregated_buffer;
+    ticket.slice_counter++;
+    return static_cast<T *>(ticket.buffer);
+  }
+
+  /// Marks the tickets of the last aggregation as empty again -- only
+  /// allowed while no slices and buffers are alive
+  void reset_buffer_tickets(void) {
+    const size_t number_tickets =
+        std::min(buffer_counter.load(), max_buffer_tickets);
+    for (size_t i = 0; i < number_tickets; i++) {
+      assert(!buffer_tickets[i].valid);
+      assert(buffer_tickets[i].view_references.unused());
+      buffer_tickets[i].state = ticket_empty;
+      buffer_tickets[i].buffer = nullptr;
+      buffer_tickets[i].ready_promise = hpx::lcos::local::promise<void>{};
+      buffer_tickets[i].ready =
+          buffer_tickets[i].ready_promise.get_shared_future();
+    }
+    buffer_counter = 0;
   }
 
   /// Notify buffer list that one slice is done with the buffer
+  /** ticket_hint is the ticket index the buffer was handed out with (if
+   * known) -- otherwise the ticket gets searched by its pointer
+   */
   template <typename T, typename Host_Allocator>
-  void mark_unused(T *p, const size_t size) {
+  void mark_unused(T *p, const size_t size,
+                   const size_t ticket_hint = max_buffer_tickets) {
     assert(slices_exhausted == true);
-
-    void *ptr_key = static_cast<void*>(p);
-    size_t slice_alloc_counter = buffer_allocations_map[p];
-
-    assert(slice_alloc_counter < buffer_allocations.size());
-    /*auto &[buffer_pointer_any, buffer_size, buffer_allocation_counter, valid] =
-        buffer_allocations[slice_alloc_counter];*/
-    auto buffer_pointer_void = std::get<0>(buffer_allocations[slice_alloc_counter]);
-    const auto buffer_size = std::get<1>(buffer_allocations[slice_alloc_counter]);
-    auto &buffer_allocation_counter = std::get<2>(buffer_allocations[slice_alloc_counter]);
-    auto &valid = std::get<3>(buffer_allocations[slice_alloc_counter]);
-    const auto &location_id = std::get<4>(buffer_allocations[slice_alloc_counter]);
-    assert(valid);
-    T *buffer_pointer = static_cast<T *>(buffer_pointer_void);
-
-    assert(buffer_size == size);
-    assert(p == buffer_pointer);
-    // assert(buffer_pointer == p || buffer_pointer == nullptr);
-    // Slice is done with this buffer
-    buffer_allocation_counter--;
-    // Check if all slices are done with this buffer?
-    if (buffer_allocation_counter == 0) {
-      // Yes! "Deallocate" by telling the recylcer the buffer is fit for reusage
-      std::lock_guard<aggregation_mutex_t> guard(buffer_mut);
-      // Only mark unused if another buffer has not done so already (and marked
-      // it as invalid)
-      if (valid) {
-        assert(buffers_in_use == true);
-        recycler::detail::buffer_recycler::mark_unused<T, Host_Allocator>(
-            buffer_pointer, buffer_size, location_id);
-        // mark buffer as invalid to prevent any other slice from marking the
-        // buffer as unused
-        valid = false;
-
-        const size_t current_deallocs = ++dealloc_counter;
-        if (current_deallocs == buffer_counter) {
+    void *ptr_key = static_cast<void *>(p);
+
+    const size_t number_tickets =
+        std::min(buffer_counter.load(), max_buffer_tickets);
+    size_t ticket_index = ticket_hint;
+    if (ticket_index >= number_tickets ||
+        buffer_tickets[ticket_index].state.load(std::memory_order_acquire) !=
+            ticket_ready ||
+        buffer_tickets[ticket_index].buffer != ptr_key) {
+      for (ticket_index = 0; ticket_index < number_tickets; ticket_index++) {
+        const buffer_ticket &ticket = buffer_tickets[ticket_index];
+        if (ticket.state.load(std::memory_order_acquire) == ticket_ready &&
+            ticket.buffer == ptr_key && ticket.valid)
+          break;
+      }
+    }
+    assert(ticket_index < number_tickets);
+    if (ticket_index >= number_tickets) {
+      // Not an aggregated buffer of the current aggregation (or given back
+      // twice): Do not touch any ticket and leave the buffer alone
+      std::cerr << "Warning! Tried to give back a buffer that is not part of "
+                   "the current aggregation!"
+                << std::endl;
+      return;
+    }
+    buffer_ticket &ticket = buffer_tickets[ticket_index];
+    assert(ticket.valid);
+    assert(ticket.size == size);
+    // Slice is done with this buffer -- Check if all slices are done with it?
+    if (ticket.slice_counter.fetch_sub(1) == 1) {
+      // Yes! "Deallocate" by telling the recylcer the buffer is fit for
+      // reusage. Only mark unused if nobody else has done so already (and
+      // marked it as invalid)
+      if (ticket.valid.exchange(false)) {
+        if (ticket.planned && keeps_plan_buffers()) {
+          // Keep it for the next round (no other slice accesses this entry
+          // before the next round starts)
+          plan_buffers[ticket_index] =
+              planned_buffer{p, ticket.size, ticket.location_id,
+                             &release_planned_buffer<T, Host_Allocator>};
+        } else {
+          recycler::detail::buffer_recycler::mark_unused<T, Host_Allocator>(
+              p, ticket.size, ticket.location_id);
+        }
+        // Last buffer of a finished aggregation? Executor can be reused
+        if (buffers_in_use.fetch_sub(1) == 1) {
           std::lock_guard<aggregation_mutex_t> guard(mut);
-          buffers_in_use = false;
-          if (!executor_slices_alive && !buffers_in_use)
+          if (!executor_slices_alive && buffers_in_use == 0)
             slices_exhausted = false;
         }
       }
@@ -671,85 +1695,98 @@ public:
   std::atomic<size_t> overall_launch_counter = 0;
 
   /// Only meant to be accessed by the slice executors
-  bool sync_aggregation_slices(const size_t slice_launch_counter) {
+  bool sync_aggregation_slices(const call_position position,
+                               const size_t number_local_slices) {
     std::lock_guard<aggregation_mutex_t> guard(mut);
     assert(slices_exhausted == true);
-    // Add function call object in case it hasn't happened for this launch yet
-    if (overall_launch_counter <= slice_launch_counter) {
-      /* std::lock_guard<aggregation_mutex_t> guard(mut); */
-      if (overall_launch_counter <= slice_launch_counter) {
-        function_calls.emplace_back(current_slices, false, executor);
-        overall_launch_counter = function_calls.size();
-        return function_calls[slice_launch_counter].sync_aggregation_slices(
-            last_stream_launch_done);
-      }
-    }
-
-    return function_calls[slice_launch_counter].sync_aggregation_slices(
-        last_stream_launch_done);
+    return function_calls[get_call_slot(position, false)]
+        .sync_aggregation_slices(last_stream_launch_done, number_local_slices);
   }
 
   /// Only meant to be accessed by the slice executors
   template <typename F, typename... Ts>
-  void post(const size_t slice_launch_counter, F &&f, Ts &&...ts) {
+  void post(const call_position position, const size_t number_local_slices,
+            F &&f, Ts &&...ts) {
     std::lock_guard<aggregation_mutex_t> guard(mut);
     assert(slices_exhausted == true);
-    // Add function call object in case it hasn't happened for this launch yet
-    if (overall_launch_counter <= slice_launch_counter) {
-      /* std::lock_guard<aggregation_mutex_t> guard(mut); */
-      if (overall_launch_counter <= slice_launch_counter) {
-        function_calls.emplace_back(current_slices, false, executor);
-        overall_launch_counter = function_calls.size();
-        function_calls[slice_launch_counter].post_when(
-            last_stream_launch_done, std::forward<F>(f), std::forward<Ts>(ts)...);
-        return;
-      }
-    }
-
-    function_calls[slice_launch_counter].post_when(
-        last_stream_launch_done, std::forward<F>(f), std::forward<Ts>(ts)...);
-    return;
+    function_calls[get_call_slot(position, false)].post_when(
+        last_stream_launch_done, number_local_slices, std::forward<F>(f),
+        std::forward<Ts>(ts)...);
   }
 
   /// Only meant to be accessed by the slice executors
   template <typename F, typename... Ts>
-  hpx::lcos::future<void> async(const size_t slice_launch_counter, F &&f,
+  hpx::lcos::future<void> async(const call_position position,
+                                const size_t number_local_slices, F &&f,
                                 Ts &&...ts) {
     std::lock_guard<aggregation_mutex_t> guard(mut);
     assert(slices_exhausted == true);
-    // Add function call object in case it hasn't happened for this launch yet
-    if (overall_launch_counter <= slice_launch_counter) {
-      /* std::lock_guard<aggregation_mutex_t> guard(mut); */
-      if (overall_launch_counter <= slice_launch_counter) {
-        function_calls.emplace_back(current_slices, true, executor);
-        overall_launch_counter = function_calls.size();
-        return function_calls[slice_launch_counter].async_when(
-            last_stream_launch_done, std::forward<F>(f), std::forward<Ts>(ts)...);
-      }
-    }
-
-    return function_calls[slice_launch_counter].async_when(
-        last_stream_launch_done, std::forward<F>(f), std::forward<Ts>(ts)...);
+    return function_calls[get_call_slot(position, true)].async_when(
+        last_stream_launch_done, number_local_slices, std::forward<F>(f),
+        std::forward<Ts>(ts)...);
+  }
+  /// Only meant to be accessed by the slice executors
+  template <typename CopyF>
+  hpx::lcos::future<void>
+  aggregated_copy(const call_position position,
+                  const size_t number_local_slices, CopyF &&copy_function,
+                  const aggregated_copy_segment segment) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    assert(slices_exhausted == true);
+    return function_calls[get_call_slot(position, true)].copy_when(
+        last_stream_launch_done, number_local_slices,
+        std::forward<CopyF>(copy_function), segment);
+  }
+  /// Only meant to be accessed by the slice executors
+  hpx::lcos::future<void>
+  aggregated_bulk(const call_position position,
+                  const size_t number_local_slices,
+                  std::shared_ptr<aggregated_bulk_part> part) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    assert(slices_exhausted == true);
+    return function_calls[get_call_slot(position, true)].bulk_when(
+        last_stream_launch_done, number_local_slices, std::move(part));
+  }
+  /// Only meant to be accessed by the slice executors
+  template <typename F, typename... Ts>
+  void async_notify(const call_position position,
+                    const size_t number_local_slices,
+                    std::function<void(std::exception_ptr)> &&on_completion,
+                    F &&f, Ts &&...ts) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    assert(slices_exhausted == true);
+    function_calls[get_call_slot(position, false)].then_when(
+        last_stream_launch_done, number_local_slices, std::move(on_completion),
+        std::forward<F>(f), std::forward<Ts>(ts)...);
   }
   /// Only meant to be accessed by the slice executors
   template <typename F, typename... Ts>
-  hpx::lcos::shared_future<void> wrap_async(const size_t slice_launch_counter, F &&f,
+  hpx::lcos::shared_future<void> wrap_async(const call_position position,
+                                const size_t number_local_slices, F &&f,
                                 Ts &&...ts) {
     std::lock_guard<aggregation_mutex_t> guard(mut);
     assert(slices_exhausted == true);
-    // Add function call object in case it hasn't happened for this launch yet
-    if (overall_launch_counter <= slice_launch_counter) {
-      /* std::lock_guard<aggregation_mutex_t> guard(mut); */
-      if (overall_launch_counter <= slice_launch_counter) {
-        function_calls.emplace_back(current_slices, true, executor);
-        overall_launch_counter = function_calls.size();
-        return function_calls[slice_launch_counter].wrap_async(
-            last_stream_launch_done, std::forward<F>(f), std::forward<Ts>(ts)...);
+    return function_calls[get_call_slot(position, true)].wrap_async(
+        last_stream_launch_done, number_local_slices, std::forward<F>(f),
+        std::forward<Ts>(ts)...);
+  }
+
+  /// Only meant to be accessed by the slice executors
+  void withdraw(
+      const std::array<size_t, max_dependency_groups> &group_launch_counters,
+      const size_t number_local_slices) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    assert(slices_exhausted == true);
+    withdrawn_slices += number_local_slices;
+    assert(withdrawn_slices <= launched_slices);
+    // Calls the slice has not visited yet should not wait for it
+    for (size_t group = 0; group < max_dependency_groups; group++) {
+      const auto &group_calls = dependency_group_calls[group];
+      for (size_t i = group_launch_counters[group]; i < group_calls.size();
+           i++) {
+        function_calls[group_calls[i]].withdraw_slices(number_local_slices);
       }
     }
-
-    return function_calls[slice_launch_counter].wrap_async(
-        last_stream_launch_done, std::forward<F>(f), std::forward<Ts>(ts)...);
   }
 
   bool slice_available(void) {
@@ -758,54 +1795,161 @@ public:
   }
 
   std::optional<hpx::lcos::future<Executor_Slice>> request_executor_slice() {
+    return request_executor_slices(1);
+  }
+
+  /// Reserves number_local_slices consecutive slices at once
+  /** Returns a single Executor_Slice standing for all of them (or an empty
+   * optional if they do not fit into the current aggregation anymore -- the
+   * slices are never split across aggregation executors).
+   */
+  std::optional<hpx::lcos::future<Executor_Slice>>
+  request_executor_slices(const size_t number_local_slices) {
+    std::optional<hpx::lcos::future<Executor_Slice>> ret;
+    reserve_executor_slices(
+        number_local_slices,
+        [&]() {
+          executor_slices.emplace_back(
+              hpx::lcos::local::promise<Executor_Slice>{});
+          executor_slices_sizes.emplace_back(number_local_slices);
+          ret = executor_slices.back().get_future();
+        },
+        [&](Executor_Slice &&slice) {
+          ret = hpx::make_ready_future(std::move(slice));
+        });
+    return ret;
+  }
+
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+  enum class Slice_Request_Result { UNAVAILABLE, PENDING, READY };
+  /// Coroutine version of request_executor_slices
+  /** On READY, slice has been emplaced right away. On PENDING, coroutine
+   * gets resumed (on the thread meeting the starting criteria) after the
+   * slice has been emplaced -- slice has to stay valid until then.
+   */
+  Slice_Request_Result
+  request_executor_slices(const size_t number_local_slices,
+                          std::coroutine_handle<> coroutine,
+                          std::optional<Executor_Slice> &slice) {
+    Slice_Request_Result result = Slice_Request_Result::UNAVAILABLE;
+    reserve_executor_slices(
+        number_local_slices,
+        [&]() {
+          awaiting_coroutines.push_back(
+              slice_awaiting_coroutine{coroutine, &slice, number_local_slices});
+          result = Slice_Request_Result::PENDING;
+        },
+        [&](Executor_Slice &&ready_slice) {
+          slice.emplace(std::move(ready_slice));
+          result = Slice_Request_Result::READY;
+        });
+    return result;
+  }
+#endif
+
+  /// Records the function calls and aggregated buffers of the next
+  /// aggregation round as launch plan
+  /** Meant for applications running the same aggregated calls with the same
+   * buffer sizes in every round (e.g. each timestep): The following rounds
+   * reuse the recorded function call objects and buffers (without
+   * requesting them from the recycler) instead of creating them again. The
+   * argument checks of DEBUG_AGGREGATION_CALLS are skipped for rounds with
+   * the same number of slices as the recorded one. Rounds deviating from the
+   * plan fall back to new calls and buffers where required. The buffers of
+   * the plan stay marked as used in the recycler until discard_launch_plan
+   * (or the destruction of the executor) -- call it before
+   * recycler::force_cleanup.
+   */
+  void record_launch_plan(void) {
     std::lock_guard<aggregation_mutex_t> guard(mut);
-    if (!slices_exhausted) {
-      const size_t local_slice_id = ++current_slices;
-      if (local_slice_id == 1) {
-        // Cleanup leftovers from last run if any
-        // TODO still required? Should be clean here already
-        function_calls.clear();
-        overall_launch_counter = 0;
-        std::lock_guard<aggregation_mutex_t> guard(buffer_mut);
-#ifndef NDEBUG
-        for (const auto &buffer_entry : buffer_allocations) {
-          const auto &[buffer_pointer_any, buffer_size,
-                       buffer_allocation_counter, valid, location_id] =
-              buffer_entry;
-          assert(!valid);
-        }
-#endif 
-        buffer_allocations.clear();
-        buffer_allocations_map.clear();
-        buffer_counter = 0;
+    plan_state = launch_plan_state::RECORD_NEXT;
+  }
+  /// Stops using the launch plan and gives its buffers back to the recycler
+  /** Buffers still used by a running round are given back once unused, the
+   * others right away (or with the next round if the executor is busy)
+   */
+  void discard_launch_plan(void) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    plan_state = launch_plan_state::DISABLED;
+    if (!executor_slices_alive && buffers_in_use == 0)
+      release_plan_buffers();
+  }
+  /// Number of rounds that matched the recorded launch plan
+  size_t get_number_plan_replays(void) const { return plan_replays; }
 
+private:
+  /// Advances the launch plan at the start of a round (mut locked, no slices
+  /// or buffers alive)
+  void update_launch_plan(void) {
+    switch (plan_state.load()) {
+    case launch_plan_state::RECORD_NEXT:
+      release_plan_buffers();
+      function_calls.clear();
+      plan_state = launch_plan_state::RECORDING;
+      break;
+    case launch_plan_state::RECORDING:
+      plan_state = launch_plan_state::RECORDED;
+      break;
+    case launch_plan_state::DISABLED:
+      // leftovers of a discarded plan
+      release_plan_buffers();
+      break;
+    case launch_plan_state::RECORDED:
+      break;
+    }
+    replaying_plan = false;
+  }
+
+  /// Reserves the slices for both request_executor_slices versions
+  /** Calls register_pending if the slices get handed out once the starting
+   * criteria is met, hand_out with the slice if it can be handed out right
+   * away. Returns false if the slices are not available.
+   */
+  template <typename Pending, typename Ready>
+  bool reserve_executor_slices(const size_t number_local_slices,
+                               Pending &&register_pending, Ready &&hand_out) {
+    assert(number_local_slices >= 1);
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    last_slice_request = std::chrono::steady_clock::now();
+    if (!slices_exhausted &&
+        (mode == Aggregated_Executor_Modes::ENDLESS ||
+         current_slices + number_local_slices <= max_slices)) {
+      const size_t local_slice_id = (current_slices += number_local_slices);
+      const bool first_request = local_slice_id == number_local_slices;
+      if (first_request) {
+        // No slices or buffers alive: Nobody else accesses the tickets (or
+        // the launch plan)
         assert(executor_slices_alive == false);
-        assert(buffers_in_use == false);
+        assert(buffers_in_use == 0);
+        update_launch_plan();
+        // Cleanup leftovers from last run if any (the calls of a launch plan
+        // are kept for reuse)
+        if (plan_state == launch_plan_state::DISABLED)
+          function_calls.clear();
+        overall_launch_counter = 0;
+        clear_dependency_group_calls();
+        withdrawn_slices = 0;
+        reset_buffer_tickets();
         executor_slices_alive = true;
-        buffers_in_use = false;
-        dealloc_counter = 0;
 
         if (mode == Aggregated_Executor_Modes::STRICT ) {
           slices_full_promise = hpx::lcos::local::promise<void>{};
         }
       }
 
-      // Create Executor Slice future -- that will be returned later
-      hpx::lcos::future<Executor_Slice> ret_fut;
+      // Register Executor Slice -- that will be handed out later
       if (local_slice_id < max_slices) {
-        executor_slices.emplace_back(hpx::lcos::local::promise<Executor_Slice>{});
-        ret_fut =
-            executor_slices[local_slice_id - 1].get_future();
+        register_pending();
       } else {
         launched_slices = current_slices;
-        ret_fut = hpx::make_ready_future(Executor_Slice{*this,
-            executor_slices.size(), launched_slices});
+        hand_out(Executor_Slice{*this, local_slice_id - number_local_slices,
+                                launched_slices, number_local_slices});
       }
 
       // Are we the first slice? If yes, add continuation set the
       // Executor_Slice
       // futures to ready if the launch conditions are met
-      if (local_slice_id == 1) {
+      if (first_request) {
         // Renew promise that all slices will be ready as the primary launch criteria...
         hpx::lcos::shared_future<void> fut;
         if (mode == Aggregated_Executor_Modes::EAGER || mode == Aggregated_Executor_Modes::ENDLESS) {
@@ -821,16 +1965,44 @@ public:
         }
         // Launch all executor slices within this continuation
         current_continuation = fut.then([this](auto &&fut) {
-          std::lock_guard<aggregation_mutex_t> guard(mut);
-          slices_exhausted = true;
-          launched_slices = current_slices;
-          size_t id = 0;
-          for (auto &slice_promise : executor_slices) {
-            slice_promise.set_value(
-                Executor_Slice{*this, id, launched_slices});
-            id++;
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+          std::vector<std::coroutine_handle<>> resumable_coroutines;
+#endif
+          {
+            std::lock_guard<aggregation_mutex_t> guard(mut);
+            slices_exhausted = true;
+            launched_slices = current_slices;
+            if (plan_state == launch_plan_state::RECORDING)
+              plan_slices = launched_slices;
+            replaying_plan = plan_state == launch_plan_state::RECORDED &&
+                             plan_slices == launched_slices;
+            if (replaying_plan)
+              plan_replays++;
+            size_t id = 0;
+            for (size_t i = 0; i < executor_slices.size(); i++) {
+              executor_slices[i].set_value(Executor_Slice{
+                  *this, id, launched_slices, executor_slices_sizes[i]});
+              id += executor_slices_sizes[i];
+            }
+            executor_slices.clear();
+            executor_slices_sizes.clear();
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+            for (auto &awaiting : awaiting_coroutines) {
+              awaiting.slice->emplace(*this, id, launched_slices,
+                                      awaiting.number_local_slices);
+              id += awaiting.number_local_slices;
+              resumable_coroutines.push_back(awaiting.coroutine);
+            }
+            awaiting_coroutines.clear();
+#endif
+          }
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+          // Resume without holding the lock: the coroutines directly
+          // continue with their slices
+          for (auto &coroutine : resumable_coroutines) {
+            coroutine.resume();
           }
-          executor_slices.clear();
+#endif
         });
       }
       if (local_slice_id >= max_slices &&
@@ -849,20 +2021,47 @@ public:
         }
         // that continuation will set all executor slices so far handed out to ready
       }
-      return ret_fut;
+      return true;
     } else {
-      // Return empty optional as failure
-      return std::optional<hpx::lcos::future<Executor_Slice>>{};
+      // No slices left in this aggregation
+      return false;
+    }
+  }
+
+public:
+  /// Launches the slices requested so far if a STRICT aggregation is starving
+  /** STRICT executors only launch once max_slices slices have been requested.
+   * If no further slices get requested (for instance as the number of tasks
+   * is not a multiple of max_slices), the pending slices would wait forever.
+   * This launches them anyway if the last slice request is at least
+   * max_idle_time ago. Returns true if a launch was forced.
+   */
+  bool force_launch_if_starving(
+      const std::chrono::steady_clock::duration max_idle_time) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    if (mode != Aggregated_Executor_Modes::STRICT || slices_exhausted ||
+        current_slices == 0) {
+      return false;
+    }
+    if (std::chrono::steady_clock::now() - last_slice_request < max_idle_time) {
+      return false;
     }
+    slices_exhausted = true; // no further slices for this aggregation
+    slices_full_promise.set_value(); // Trigger slices launch condition continuation
+    forced_launches++;
+    return true;
   }
+  size_t get_number_forced_launches(void) const { return forced_launches; }
+
   size_t launched_slices;
-  void reduce_usage_counter(void) {
+  void reduce_usage_counter(const size_t number_local_slices = 1) {
     /* std::lock_guard<aggregation_mutex_t> guard(mut); */
     assert(slices_exhausted == true);
     assert(executor_slices_alive == true);
     assert(launched_slices >= 1);
-    assert(current_slices >= 0 && current_slices <= launched_slices);
-    const size_t local_slice_id = --current_slices;
+    assert(current_slices >= number_local_slices &&
+           current_slices <= launched_slices);
+    const size_t local_slice_id = (current_slices -= number_local_slices);
     // Last slice goes out scope?
     if (local_slice_id == 0) {
 
@@ -876,7 +2075,7 @@ public:
 
       std::lock_guard<aggregation_mutex_t> guard(mut);
       executor_slices_alive = false; 
-      if (!executor_slices_alive && !buffers_in_use) {
+      if (!executor_slices_alive && buffers_in_use == 0) {
         slices_exhausted = false;
       }
     }
@@ -885,7 +2084,7 @@ public:
 
     assert(current_slices == 0);
     assert(executor_slices_alive == false);
-    assert(buffers_in_use == false);
+    assert(buffers_in_use == 0);
 
     if (mode != Aggregated_Executor_Modes::STRICT ) {
         slices_full_promise.set_value(); // Trigger slices launch condition continuation 
@@ -894,30 +2093,35 @@ public:
     // Cleanup leftovers from last run if any
     function_calls.clear();
     overall_launch_counter = 0;
-#ifndef NDEBUG
-    for (const auto &buffer_entry : buffer_allocations) {
-      const auto &[buffer_pointer_any, buffer_size, buffer_allocation_counter,
-                   valid, location_id] = buffer_entry;
-      assert(!valid);
-    }
-#endif
-    buffer_allocations.clear();
-    buffer_allocations_map.clear();
-    buffer_counter = 0;
-
-    assert(buffer_allocations.empty());
-    assert(buffer_allocations_map.empty());
+    clear_dependency_group_calls();
+    reset_buffer_tickets();
+    release_plan_buffers();
   }
 
   Aggregated_Executor(const size_t number_slices,
-                      Aggregated_Executor_Modes mode)
-      : max_slices(number_slices), current_slices(0), slices_exhausted(false),dealloc_counter(0),
-        mode(mode), executor_slices_alive(false), buffers_in_use(false),
+                      Aggregated_Executor_Modes mode,
+                      std::optional<size_t> location_hint = std::nullopt)
+      : max_slices(number_slices), current_slices(0), slices_exhausted(false),
+        mode(mode), executor_slices_alive(false),
         executor_tuple(
             stream_pool::get_interface<Executor, round_robin_pool<Executor>>()),
         executor(std::get<0>(executor_tuple)),
+        buffer_location(location_hint.value_or(std::get<1>(executor_tuple) %
+                                               recycler::number_instances)),
+        last_slice_request(std::chrono::steady_clock::now()),
         current_continuation(hpx::make_ready_future()),
-        last_stream_launch_done(hpx::make_ready_future()) {}
+        last_stream_launch_done(hpx::make_ready_future()) {
+    if constexpr (fixed_slices > 0) {
+      if (max_slices > fixed_slices ||
+          mode == Aggregated_Executor_Modes::ENDLESS) {
+        throw std::runtime_error(
+            "Aggregated_Executor: Fixed-capacity executor (" +
+            std::to_string(fixed_slices) +
+            " slices) requires max_slices <= " + std::to_string(fixed_slices) +
+            " and a mode other than ENDLESS");
+      }
+    }
+  }
   // Not meant to be copied or moved
   Aggregated_Executor(const Aggregated_Executor &other) = delete;
   Aggregated_Executor &operator=(const Aggregated_Executor &other) = delete;
@@ -925,27 +2129,45 @@ public:
   Aggregated_Executor &operator=(Aggregated_Executor &&other) = delete;
 };
 
-template <typename T, typename Host_Allocator, typename Executor>
+template <typename T, typename Host_Allocator, typename Executor,
+          size_t fixed_slices>
 class Allocator_Slice {
 private:
-  typename Aggregated_Executor<Executor>::Executor_Slice &executor_reference;
-  Aggregated_Executor<Executor> &executor_parent;
+  using aggregated_executor_t = Aggregated_Executor<Executor, fixed_slices>;
+  typename aggregated_executor_t::Executor_Slice &executor_reference;
+  aggregated_executor_t &executor_parent;
+  /// Buffer ticket of the last allocation -- lookup hint for deallocate
+  size_t ticket_index{aggregated_executor_t::max_buffer_tickets};
 
 public:
   using value_type = T;
-  Allocator_Slice(
-      typename Aggregated_Executor<Executor>::Executor_Slice &executor)
+  /// Required as the default rebind does not work with fixed_slices
+  template <typename U> struct rebind {
+    using other = Allocator_Slice<U, Host_Allocator, Executor, fixed_slices>;
+  };
+  Allocator_Slice(typename aggregated_executor_t::Executor_Slice &executor)
       : executor_reference(executor), executor_parent(executor.parent) {}
   template <typename U>
   explicit Allocator_Slice(
-      Allocator_Slice<U, Host_Allocator, Executor> const &) noexcept {}
+      Allocator_Slice<U, Host_Allocator, Executor, fixed_slices> const &) noexcept {}
   T *allocate(std::size_t n) {
-    T *data = executor_reference.template get<T, Host_Allocator>(n);
+    T *data =
+        executor_reference.template get<T, Host_Allocator>(n, ticket_index);
+    return data;
+  }
+  /// allocate, also returning the view reference counter of the buffer ticket
+  /// -- shared by the views of all slices (see aggregated_recycled_view)
+  T *allocate_counted(std::size_t n,
+                      recycler::detail::view_reference_counter *&reference_counter) {
+    T *data = allocate(n);
+    reference_counter =
+        &executor_parent.buffer_tickets[ticket_index].view_references;
     return data;
   }
   void deallocate(T *p, std::size_t n) {
     /* executor_reference.template mark_unused<T, Host_Allocator>(p, n); */
-    executor_parent.template mark_unused<T, Host_Allocator>(p, n);
+    executor_parent.template mark_unused<T, Host_Allocator>(p, n,
+                                                           ticket_index);
   }
   template <typename... Args>
   inline void construct(T *p, Args... args) noexcept {
@@ -956,112 +2178,522 @@ public:
     // destroyed, not before
   }
 };
-template <typename T, typename U, typename Host_Allocator, typename Executor>
+template <typename T, typename U, typename Host_Allocator, typename Executor,
+          size_t fixed_slices>
 constexpr bool
-operator==(Allocator_Slice<T, Host_Allocator, Executor> const &,
-           Allocator_Slice<U, Host_Allocator, Executor> const &) noexcept {
+operator==(Allocator_Slice<T, Host_Allocator, Executor, fixed_slices> const &,
+           Allocator_Slice<U, Host_Allocator, Executor, fixed_slices> const &) noexcept {
   return false;
 }
-template <typename T, typename U, typename Host_Allocator, typename Executor>
+template <typename T, typename U, typename Host_Allocator, typename Executor,
+          size_t fixed_slices>
 constexpr bool
-operator!=(Allocator_Slice<T, Host_Allocator, Executor> const &,
-           Allocator_Slice<U, Host_Allocator, Executor> const &) noexcept {
+operator!=(Allocator_Slice<T, Host_Allocator, Executor, fixed_slices> const &,
+           Allocator_Slice<U, Host_Allocator, Executor, fixed_slices> const &) noexcept {
   return true;
 }
 
+/// Is T an Executor_Slice (of any Aggregated_Executor)? The nested slice type
+/// cannot be matched by a partial specialization directly (non-deduced
+/// context), so we detect it with its aggregated_executor_t instead
+template <typename T, typename = void>
+struct is_aggregated_executor_slice : std::false_type {};
+template <typename T>
+struct is_aggregated_executor_slice<
+    T, std::void_t<typename T::aggregated_executor_t>>
+    : std::is_same<T, typename T::aggregated_executor_t::Executor_Slice> {};
+template <typename T>
+inline constexpr bool is_aggregated_executor_slice_v =
+    is_aggregated_executor_slice<T>::value;
+
 namespace hpx { namespace parallel { namespace execution {
-   // TODO Unfortunately does not work that way! Create trait that works for Executor Slices with 
-   // compatible unlying executor types
-    /* template<typename E> */
-    /* struct is_one_way_executor<typename Aggregated_Executor<E>::Executor_Slice> */
-    /*   : std::true_type */
-    /* {}; */
-    /* template<typename E> */
-    /* struct is_two_way_executor<typename Aggregated_Executor<E>::Executor_Slice> */
-    /*   : std::true_type */
-    /* {}; */
-
-#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
-    // Workaround for the meantime: Manually create traits for compatible types:
-    template<>
-    struct is_one_way_executor<typename Aggregated_Executor<hpx::cuda::experimental::cuda_executor>::Executor_Slice>
+    // Executor traits for the slices of all underlying executor types (this
+    // enables using the slices with the HPX parallel algorithms)
+    template <typename Slice>
+    struct is_one_way_executor<
+        Slice, std::enable_if_t<is_aggregated_executor_slice_v<Slice>>>
       : std::true_type
     {};
-    template<>
-    struct is_two_way_executor<typename Aggregated_Executor<hpx::cuda::experimental::cuda_executor>::Executor_Slice>
+    template <typename Slice>
+    struct is_two_way_executor<
+        Slice, std::enable_if_t<is_aggregated_executor_slice_v<Slice>>>
+      : std::true_type
+    {};
+    template <typename Slice>
+    struct is_bulk_one_way_executor<
+        Slice, std::enable_if_t<is_aggregated_executor_slice_v<Slice>>>
+      : std::true_type
+    {};
+    template <typename Slice>
+    struct is_bulk_two_way_executor<
+        Slice, std::enable_if_t<is_aggregated_executor_slice_v<Slice>>>
       : std::true_type
     {};
-#endif
 }}}
 
+#if defined(CPPUDDLE_HAVE_AGGREGATION_SENDERS)
+//===============================================================================
+//===============================================================================
+// Sender interface:
+//
+// Executor slices (and stream interfaces) can be used as start of P2300 style
+// sender pipelines: schedule(slice) yields a sender the aggregated stages
+// aggregated_then/aggregated_bulk can be attached to. The aggregated stages
+// complete once the aggregated launch is done -- without any intermediate
+// futures per slice.
+
+/// Sender returned by schedule(slice): completes (inline) without values and
+/// carries the slice for the subsequent aggregated stages
+template <typename Slice> struct aggregated_schedule_sender {
+  Slice *slice;
+
+  template <template <typename...> class Tuple,
+            template <typename...> class Variant>
+  using value_types = Variant<Tuple<>>;
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+  static constexpr bool sends_done = false;
+  static constexpr bool sends_stopped = false;
+
+  template <typename Receiver> struct operation_state {
+    std::decay_t<Receiver> receiver;
+    friend void tag_invoke(hpx::execution::experimental::start_t,
+                           operation_state &os) noexcept {
+      hpx::execution::experimental::set_value(std::move(os.receiver));
+    }
+  };
+  template <typename Receiver>
+  friend operation_state<Receiver>
+  tag_invoke(hpx::execution::experimental::connect_t,
+             aggregated_schedule_sender sender, Receiver &&receiver) {
+    return operation_state<Receiver>{std::forward<Receiver>(receiver)};
+  }
+};
+
+/// Sender of an aggregated function call: completes once the aggregated
+/// launch (containing the calls of all slices) is done
+template <typename Slice, typename F, typename... Ts>
+struct aggregated_then_sender {
+  Slice *slice;
+  std::tuple<F, Ts...> call;
+
+  template <template <typename...> class Tuple,
+            template <typename...> class Variant>
+  using value_types = Variant<Tuple<>>;
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+  static constexpr bool sends_done = false;
+  static constexpr bool sends_stopped = false;
+
+  template <typename Receiver> struct operation_state {
+    Slice *slice;
+    std::tuple<F, Ts...> call;
+    std::decay_t<Receiver> receiver;
+    friend void tag_invoke(hpx::execution::experimental::start_t,
+                           operation_state &os) noexcept {
+      try {
+        // The arguments stay in the operation state until the completion
+        std::apply(
+            [&os](auto &f, auto &...ts) {
+              os.slice->async_notify(
+                  [&os](std::exception_ptr launch_exception) {
+                    if (launch_exception) {
+                      hpx::execution::experimental::set_error(
+                          std::move(os.receiver), launch_exception);
+                    } else {
+                      hpx::execution::experimental::set_value(
+                          std::move(os.receiver));
+                    }
+                  },
+                  f, ts...);
+            },
+            os.call);
+      } catch (...) {
+        hpx::execution::experimental::set_error(std::move(os.receiver),
+                                                std::current_exception());
+      }
+    }
+  };
+  template <typename Receiver>
+  friend operation_state<Receiver>
+  tag_invoke(hpx::execution::experimental::connect_t,
+             aggregated_then_sender &&sender, Receiver &&receiver) {
+    return operation_state<Receiver>{sender.slice, std::move(sender.call),
+                                     std::forward<Receiver>(receiver)};
+  }
+};
+
+/// Aggregated then stage: f(ts...) is launched once on the underlying
+/// executor after all slices reached this stage
+template <typename Slice, typename F, typename... Ts>
+aggregated_then_sender<Slice, std::decay_t<F>, std::decay_t<Ts>...>
+aggregated_then(aggregated_schedule_sender<Slice> sender, F &&f, Ts &&...ts) {
+  return {sender.slice, {std::forward<F>(f), std::forward<Ts>(ts)...}};
+}
+
+/// Aggregated bulk stage: Each slice contributes shape elements -- the
+/// aggregated launch calls f(shape * number_slices, ts...) once (the kernel
+/// convention used with the aggregation buffers)
+template <typename Slice, typename F, typename... Ts>
+aggregated_then_sender<Slice, std::decay_t<F>, size_t, std::decay_t<Ts>...>
+aggregated_bulk(aggregated_schedule_sender<Slice> sender, const size_t shape,
+                F &&f, Ts &&...ts) {
+  return {sender.slice,
+          {std::forward<F>(f), shape * sender.slice->number_slices,
+           std::forward<Ts>(ts)...}};
+}
+
+/// Sender returned by schedule(stream_interface): completes once the work
+/// previously enqueued to the underlying executor is done
+template <typename Interface> struct stream_schedule_sender {
+  Interface *interface;
+
+  template <template <typename...> class Tuple,
+            template <typename...> class Variant>
+  using value_types = Variant<Tuple<>>;
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+  static constexpr bool sends_done = false;
+  static constexpr bool sends_stopped = false;
+
+  template <typename Receiver> struct operation_state {
+    Interface *interface;
+    std::decay_t<Receiver> receiver;
+    friend void tag_invoke(hpx::execution::experimental::start_t,
+                           operation_state &os) noexcept {
+      os.interface->get_future().then([&os](auto &&fut) {
+        try {
+          fut.get();
+          hpx::execution::experimental::set_value(std::move(os.receiver));
+        } catch (...) {
+          hpx::execution::experimental::set_error(std::move(os.receiver),
+                                                  std::current_exception());
+        }
+      });
+    }
+  };
+  template <typename Receiver>
+  friend operation_state<Receiver>
+  tag_invoke(hpx::execution::experimental::connect_t,
+             stream_schedule_sender sender, Receiver &&receiver) {
+    return operation_state<Receiver>{sender.interface,
+                                     std::forward<Receiver>(receiver)};
+  }
+};
+
+template <class Interface, class Pool>
+stream_schedule_sender<Interface>
+tag_invoke(hpx::execution::experimental::schedule_t,
+           stream_interface<Interface, Pool> &stream) {
+  return stream_schedule_sender<Interface>{&stream.interface};
+}
+#endif
+
 //===============================================================================
 //===============================================================================
 // Pool Strategy:
 
-template <const char *kernelname, class Interface, class Pool>
+/// Pool of aggregation executors for one kernel (fixed_slices > 0: pool of
+/// Aggregated_Executor<Interface, fixed_slices> -- see there)
+template <const char *kernelname, class Interface, class Pool,
+          size_t fixed_slices = 0>
 class aggregation_pool {
 public:
   /// interface
+  /** The pool can optionally be partitioned into number_of_worker_groups
+   * groups of consecutive HPX worker threads (by worker index -- the machine
+   * topology is not queried). Slices are then only aggregated with slices
+   * requested from the same group and the aggregated buffers are taken from
+   * the recycler locations of the group. The number_of_executors are
+   * distributed among the groups (leftover executors go to the first groups,
+   * at least one executor per group).
+   */
   template <typename... Ts>
   static void init(size_t number_of_executors, size_t slices_per_executor,
-                   Aggregated_Executor_Modes mode) {
+                   Aggregated_Executor_Modes mode,
+                   size_t number_of_worker_groups = 1) {
     std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
     assert(instance.aggregation_executor_pool.empty());
-    for (int i = 0; i < number_of_executors; i++) {
-      instance.aggregation_executor_pool.emplace_back(slices_per_executor,
-                                                      mode);
-    }
+    assert(number_of_worker_groups >= 1);
     instance.slices_per_executor = slices_per_executor;
     instance.mode = mode;
+    instance.number_of_worker_groups = number_of_worker_groups;
+    const size_t number_workers = hpx::get_num_worker_threads();
+    instance.workers_per_group =
+        (number_workers + number_of_worker_groups - 1) /
+        number_of_worker_groups;
+    if (instance.workers_per_group == 0)
+      instance.workers_per_group = 1;
+
+    const size_t executors_per_group =
+        number_of_executors / number_of_worker_groups;
+    const size_t leftover_executors =
+        number_of_executors % number_of_worker_groups;
+    for (size_t group = 0; group < number_of_worker_groups; group++) {
+      instance.aggregation_executor_pool.emplace_back();
+      instance.current_interface.emplace_back(0);
+      const size_t group_executors = std::max(
+          executors_per_group + (group < leftover_executors ? 1 : 0),
+          size_t{1});
+      for (size_t i = 0; i < group_executors; i++) {
+        instance.aggregation_executor_pool[group].emplace_back(
+            slices_per_executor, mode, get_buffer_location(group, i));
+      }
+    }
   }
 
   /// Will always return a valid executor slice
   static decltype(auto) request_executor_slice(void) {
+    return request_executor_slices(1);
+  }
+
+  /// Reserves number_local_slices consecutive slices on the same aggregation
+  /// executor -- will always return a valid (multi-)slice as long as
+  /// number_local_slices does not exceed the slices per executor
+  static decltype(auto) request_executor_slices(size_t number_local_slices) {
+    std::optional<hpx::lcos::future<typename Aggregated_Executor<
+        Interface, fixed_slices>::Executor_Slice>>
+        ret;
+    request_from_pool(number_local_slices, [&](auto &executor) {
+      ret = executor.request_executor_slices(number_local_slices);
+      return ret.has_value();
+    });
+    return ret;
+  }
+
+#if defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+  /// Awaitable returned by co_request_executor_slice(s)
+  class slice_awaitable {
+  private:
+    using executor_slice_t = typename Aggregated_Executor<
+        Interface, fixed_slices>::Executor_Slice;
+    using request_result_t = typename Aggregated_Executor<
+        Interface, fixed_slices>::Slice_Request_Result;
+    const size_t number_local_slices;
+    /// Emplaced by the aggregation executor once the slice is ready
+    std::optional<executor_slice_t> slice;
+
+  public:
+    explicit slice_awaitable(const size_t number_local_slices)
+        : number_local_slices(number_local_slices) {}
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> coroutine) {
+      request_result_t result = request_result_t::UNAVAILABLE;
+      const bool found_slices =
+          request_from_pool(number_local_slices, [&](auto &executor) {
+            result = executor.request_executor_slices(number_local_slices,
+                                                      coroutine, slice);
+            return result != request_result_t::UNAVAILABLE;
+          });
+      assert(found_slices);
+      // Only suspend if the slice is not ready yet (the coroutine may already
+      // be resumed concurrently after the request -- do not touch the
+      // awaitable anymore)
+      return result == request_result_t::PENDING;
+    }
+    executor_slice_t await_resume() {
+      assert(slice.has_value());
+      return std::move(*slice);
+    }
+  };
+  /// Coroutine version of request_executor_slice: auto slice = co_await
+  /// pool::co_request_executor_slice() resumes the coroutine directly once
+  /// the slice is ready (no future involved)
+  static slice_awaitable co_request_executor_slice(void) {
+    return slice_awaitable{1};
+  }
+  /// Coroutine version of request_executor_slices
+  static slice_awaitable
+  co_request_executor_slices(const size_t number_local_slices) {
+    return slice_awaitable{number_local_slices};
+  }
+#endif
+
+  /// Starvation check for STRICT pools
+  /** Force-launches all executors with pending slices if the whole pool has
+   * not received a slice request for max_idle_time and the HPX scheduler has
+   * idle worker threads (no more slices are coming to complete these
+   * aggregations). Returns the number of forced launches.
+   */
+  static size_t
+  launch_starving_executors(std::chrono::steady_clock::duration max_idle_time) {
+    // The calling thread itself is busy -- with a single worker thread, the
+    // idleness of the pool has to suffice
+    if (hpx::get_num_worker_threads() > 1 &&
+        hpx::threads::get_idle_core_count() == 0) {
+      return 0;
+    }
+    std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    if (std::chrono::steady_clock::now() - instance.last_slice_request <
+        max_idle_time) {
+      return 0;
+    }
+    size_t number_launches = 0;
+    for (auto &group_pool : instance.aggregation_executor_pool) {
+      for (auto &executor : group_pool) {
+        if (executor.force_launch_if_starving(max_idle_time))
+          number_launches++;
+      }
+    }
+    return number_launches;
+  }
+
+  /// Runs launch_starving_executors every check_interval in an HPX task
+  /// until stop_watchdog is called -- hpx::finalize stops it as well
+  static void start_watchdog(std::chrono::steady_clock::duration check_interval) {
+    std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    assert(!instance.watchdog_running);
+    instance.watchdog_running = true;
+    instance.watchdog_future = hpx::async([check_interval]() {
+      while (instance.watchdog_running) {
+        hpx::this_thread::sleep_for(check_interval);
+        launch_starving_executors(check_interval);
+      }
+    });
+    // The runtime would wait for the watchdog task forever otherwise
+    if (!instance.watchdog_shutdown_registered) {
+      hpx::register_pre_shutdown_function([]() { stop_watchdog(); });
+      instance.watchdog_shutdown_registered = true;
+    }
+  }
+  static void stop_watchdog(void) {
+    instance.watchdog_running = false;
+    if (instance.watchdog_future.valid())
+      instance.watchdog_future.get();
+  }
+
+  /// Number of launches forced by the starvation checks so far
+  static size_t get_number_forced_launches(void) {
+    std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    size_t number_launches = 0;
+    for (auto &group_pool : instance.aggregation_executor_pool) {
+      for (auto &executor : group_pool) {
+        number_launches += executor.get_number_forced_launches();
+      }
+    }
+    return number_launches;
+  }
+
+  /// Records launch plans on all executors of the pool (executors added
+  /// later record their first round) -- see
+  /// Aggregated_Executor::record_launch_plan
+  static void record_launch_plans(void) {
+    std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    instance.record_launch_plans_enabled = true;
+    for (auto &group_pool : instance.aggregation_executor_pool) {
+      for (auto &executor : group_pool) {
+        executor.record_launch_plan();
+      }
+    }
+  }
+  /// Discards the launch plans of all executors of the pool
+  static void discard_launch_plans(void) {
+    std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    instance.record_launch_plans_enabled = false;
+    for (auto &group_pool : instance.aggregation_executor_pool) {
+      for (auto &executor : group_pool) {
+        executor.discard_launch_plan();
+      }
+    }
+  }
+  /// Number of rounds (of all executors) that matched their launch plan
+  static size_t get_number_plan_replays(void) {
     std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    size_t number_replays = 0;
+    for (auto &group_pool : instance.aggregation_executor_pool) {
+      for (auto &executor : group_pool) {
+        number_replays += executor.get_number_plan_replays();
+      }
+    }
+    return number_replays;
+  }
+
+private:
+  /// Tries try_request(executor) on the executors of the current worker
+  /// group (round robin, starting with the current one) until it succeeds --
+  /// adds a new executor if all are busy. Returns false if that fails as well
+  template <typename Request>
+  static bool request_from_pool(const size_t number_local_slices,
+                                Request &&try_request) {
+    std::lock_guard<aggregation_mutex_t> guard(instance.pool_mutex);
+    assert(number_local_slices >= 1);
+    assert(number_local_slices <= instance.slices_per_executor);
+    instance.last_slice_request = std::chrono::steady_clock::now();
     assert(!instance.aggregation_executor_pool.empty());
-    std::optional<hpx::lcos::future<
-        typename Aggregated_Executor<Interface>::Executor_Slice>>
-        ret;
-    size_t local_id = (instance.current_interface) %
-                      instance.aggregation_executor_pool.size();
-    ret = instance.aggregation_executor_pool[local_id].request_executor_slice();
+    const size_t group = get_worker_group();
+    auto &group_pool = instance.aggregation_executor_pool[group];
+    auto &current_interface = instance.current_interface[group];
+    size_t local_id = current_interface % group_pool.size();
     // Expected case: current aggregation executor is free
-    if (ret.has_value()) {
-      return ret;
+    if (try_request(group_pool[local_id])) {
+      return true;
     }
     // current interface is bad -> find free one
     size_t abort_counter = 0;
-    const size_t abort_number = instance.aggregation_executor_pool.size() + 1;
+    const size_t abort_number = group_pool.size() + 1;
     do {
-      local_id = (++(instance.current_interface)) % // increment interface
-                 instance.aggregation_executor_pool.size();
-      ret =
-          instance.aggregation_executor_pool[local_id].request_executor_slice();
-      if (ret.has_value()) {
-        return ret;
+      local_id = (++current_interface) % // increment interface
+                 group_pool.size();
+      if (try_request(group_pool[local_id])) {
+        return true;
       }
       abort_counter++;
     } while (abort_counter <= abort_number);
     // Everything's busy -> create new aggregation executor (growing pool) OR
-    // return empty optional
+    // fail
     if (instance.growing_pool) {
-      instance.aggregation_executor_pool.emplace_back(
-          instance.slices_per_executor, instance.mode);
-      instance.current_interface = instance.aggregation_executor_pool.size() - 1;
-      assert(instance.aggregation_executor_pool.size() < 20480);
-      ret = instance.aggregation_executor_pool[instance.current_interface].request_executor_slice();
-      assert(ret.has_value()); // fresh executor -- should always have slices
-                               // available
+      group_pool.emplace_back(instance.slices_per_executor, instance.mode,
+                              get_buffer_location(group, group_pool.size()));
+      current_interface = group_pool.size() - 1;
+      assert(group_pool.size() < 20480);
+      if (instance.record_launch_plans_enabled)
+        group_pool[current_interface].record_launch_plan();
+      const bool success = try_request(group_pool[current_interface]);
+      assert(success); // fresh executor -- should always have slices
+                       // available
+      return success;
     }
-    return ret;
+    return false;
   }
 
-private:
-  std::deque<Aggregated_Executor<Interface>> aggregation_executor_pool;
-  std::atomic<size_t> current_interface{0};
+  /// One deque of aggregation executors per worker group
+  std::deque<std::deque<Aggregated_Executor<Interface, fixed_slices>>>
+      aggregation_executor_pool;
+  /// Current (round robin) executor of each worker group
+  std::deque<size_t> current_interface;
   size_t slices_per_executor;
   Aggregated_Executor_Modes mode;
+  size_t number_of_worker_groups{1};
+  size_t workers_per_group{1};
   bool growing_pool{true};
+  /// New executors record launch plans as well (see record_launch_plans)
+  bool record_launch_plans_enabled{false};
+  /// Time of the last slice request to any executor of the pool
+  std::chrono::steady_clock::time_point last_slice_request{
+      std::chrono::steady_clock::now()};
+  std::atomic<bool> watchdog_running{false};
+  hpx::lcos::future<void> watchdog_future;
+  bool watchdog_shutdown_registered{false};
+
+  /// Worker group of the current worker thread
+  static size_t get_worker_group(void) {
+    if (instance.number_of_worker_groups == 1)
+      return 0;
+    const size_t worker_id = hpx::get_worker_thread_num();
+    // Threads outside of the HPX worker pool always use the first group
+    if (worker_id == static_cast<size_t>(-1))
+      return 0;
+    return std::min(worker_id / instance.workers_per_group,
+                    instance.number_of_worker_groups - 1);
+  }
+  /// Recycler location for the buffers of an aggregation executor: Spreads
+  /// the executors of a group over the locations of the group's workers
+  static size_t get_buffer_location(const size_t group,
+                                    const size_t executor_id) {
+    return (group * instance.workers_per_group +
+            executor_id % instance.workers_per_group) %
+           recycler::number_instances;
+  }
 
 private:
   /// Required for dealing with adding elements to the deque of
@@ -1080,4 +2712,420 @@ public:
   aggregation_pool &operator=(aggregation_pool &&other) = delete;
 };
 
+//===============================================================================
+//===============================================================================
+// Hierarchical aggregation:
+
+/// Sub-batch of a hierarchical_aggregation_pool: Up to capacity tasks (of one
+/// worker group) share one multi-slice of the top-level aggregation executor
+/** The calls and buffer requests of the members are aggregated within the
+ * sub-batch first -- only the last arriving member forwards each of them to
+ * the multi-slice. Thus the top-level executor (its mutex and counters) only
+ * sees one arrival per sub-batch. The members get consecutive slice ids
+ * within the multi-slice, so their parts of the aggregated buffers are laid
+ * out contiguously. In STRICT mode a sub-batch waits until it is full.
+ * Otherwise, a sub-batch that gets its multi-slice before it is full starts
+ * with fewer members -- the slice ids of the missing members are not
+ * used then (but still count for the aggregation).
+ */
+template <typename Executor, size_t fixed_slices = 0>
+class aggregation_sub_batch
+    : public std::enable_shared_from_this<
+          aggregation_sub_batch<Executor, fixed_slices>> {
+public:
+  using aggregated_executor_t = Aggregated_Executor<Executor, fixed_slices>;
+  using Executor_Slice = typename aggregated_executor_t::Executor_Slice;
+
+  /// Slice handed out to the members of the sub-batch (same interface for
+  /// calls and allocators as Executor_Slice)
+  class Sub_Batch_Slice {
+  private:
+    std::shared_ptr<aggregation_sub_batch> batch;
+    size_t launch_counter{0};
+    size_t buffer_counter{0};
+
+  public:
+    /// How many slices are there overall (in the top-level aggregation)
+    size_t number_slices;
+    size_t id;
+    static constexpr size_t number_local_slices = 1;
+    using executor_t = Executor;
+
+    Sub_Batch_Slice(std::shared_ptr<aggregation_sub_batch> batch,
+                    const size_t member_id)
+        : batch(std::move(batch)),
+          number_slices(this->batch->slice->number_slices),
+          id(this->batch->slice->id + member_id) {}
+    ~Sub_Batch_Slice(void) {
+      // Don't notify the sub-batch if we moved away from this slice
+      if (batch)
+        batch->member_done();
+    }
+    Sub_Batch_Slice(const Sub_Batch_Slice &other) = delete;
+    Sub_Batch_Slice &operator=(const Sub_Batch_Slice &other) = delete;
+    Sub_Batch_Slice(Sub_Batch_Slice &&other) = default;
+    Sub_Batch_Slice &operator=(Sub_Batch_Slice &&other) = delete;
+
+    template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+      batch->post(launch_counter, std::forward<F>(f), std::forward<Ts>(ts)...);
+      launch_counter++;
+    }
+    template <typename F, typename... Ts>
+    hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+      hpx::lcos::future<void> ret_fut = batch->async(
+          launch_counter, std::forward<F>(f), std::forward<Ts>(ts)...);
+      launch_counter++;
+      return ret_fut;
+    }
+
+    template <typename T, typename Host_Allocator> T *get(const size_t size) {
+      T *aggregated_buffer =
+          batch->template get<T, Host_Allocator>(buffer_counter, size);
+      buffer_counter++;
+      return aggregated_buffer;
+    }
+    template <typename T, typename Host_Allocator>
+    void mark_unused(T *p, const size_t size) {
+      batch->template mark_unused<T, Host_Allocator>(p, size);
+    }
+
+    template <typename T, typename Host_Allocator> class Allocator_Sub_Slice {
+    private:
+      Sub_Batch_Slice &slice;
+
+    public:
+      using value_type = T;
+      template <typename U> struct rebind {
+        using other = Allocator_Sub_Slice<U, Host_Allocator>;
+      };
+      Allocator_Sub_Slice(Sub_Batch_Slice &slice) : slice(slice) {}
+      T *allocate(std::size_t n) {
+        return slice.template get<T, Host_Allocator>(n);
+      }
+      void deallocate(T *p, std::size_t n) {
+        slice.template mark_unused<T, Host_Allocator>(p, n);
+      }
+      template <typename... Args>
+      inline void construct(T *p, Args... args) noexcept {
+        // Do nothing here - we reuse the content of the last owner
+      }
+      void destroy(T *p) {
+        // Do nothing here - Contents will be destroyed when the buffer
+        // manager is destroyed, not before
+      }
+      friend constexpr bool operator==(const Allocator_Sub_Slice &,
+                                       const Allocator_Sub_Slice &) noexcept {
+        return false;
+      }
+      friend constexpr bool operator!=(const Allocator_Sub_Slice &,
+                                       const Allocator_Sub_Slice &) noexcept {
+        return true;
+      }
+    };
+    template <typename T, typename Host_Allocator>
+    Allocator_Sub_Slice<T, Host_Allocator> make_allocator() {
+      return Allocator_Sub_Slice<T, Host_Allocator>(*this);
+    }
+  };
+
+private:
+  const size_t capacity;
+  const bool wait_until_full;
+  /// Guards everything below
+  aggregation_mutex_t mut;
+  /// Members waiting for the multi-slice
+  std::vector<hpx::lcos::local::promise<Sub_Batch_Slice>> member_promises;
+  /// No further members once the multi-slice got handed out
+  bool closed{false};
+  size_t number_members{0};
+  size_t alive_members{0};
+  std::optional<Executor_Slice> slice;
+
+  /// Aggregated call within the sub-batch (by call index)
+  struct pending_call {
+    size_t arrived{0};
+    std::vector<hpx::lcos::local::promise<void>> promises;
+  };
+  std::deque<pending_call> calls;
+  /// Aggregated buffer within the sub-batch (by buffer index)
+  struct pending_buffer {
+    void *buffer{nullptr};
+    size_t size{0};
+    size_t ticket_index{0};
+    size_t released{0};
+  };
+  std::deque<pending_buffer> buffers;
+
+  pending_call &get_call(const size_t call_index) {
+    while (calls.size() <= call_index)
+      calls.emplace_back();
+    return calls[call_index];
+  }
+
+  template <typename F, typename... Ts>
+  void post(const size_t call_index, F &&f, Ts &&...ts) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    pending_call &call = get_call(call_index);
+    call.arrived++;
+    assert(call.arrived <= number_members);
+    // Last member forwards the call (still holding mut: keeps the order of
+    // the forwarded calls)
+    if (call.arrived == number_members)
+      slice->post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+  template <typename F, typename... Ts>
+  hpx::lcos::future<void> async(const size_t call_index, F &&f, Ts &&...ts) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    pending_call &call = get_call(call_index);
+    if (call.arrived == 0)
+      call.promises.resize(number_members);
+    hpx::lcos::future<void> ret_fut = call.promises[call.arrived].get_future();
+    call.arrived++;
+    assert(call.arrived <= number_members);
+    if (call.arrived == number_members) {
+      slice->async(std::forward<F>(f), std::forward<Ts>(ts)...)
+          .then([promises = std::move(call.promises)](auto &&fut) mutable {
+            std::exception_ptr launch_exception{};
+            try {
+              fut.get();
+            } catch (...) {
+              launch_exception = std::current_exception();
+            }
+            for (auto &promise : promises) {
+              if (launch_exception)
+                promise.set_exception(launch_exception);
+              else
+                promise.set_value();
+            }
+          });
+    }
+    return ret_fut;
+  }
+
+  template <typename T, typename Host_Allocator>
+  T *get(const size_t buffer_index, const size_t size) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    while (buffers.size() <= buffer_index)
+      buffers.emplace_back();
+    pending_buffer &buffer = buffers[buffer_index];
+    if (buffer.buffer == nullptr) {
+      buffer.buffer = static_cast<void *>(
+          slice->template get<T, Host_Allocator>(size, buffer.ticket_index));
+      buffer.size = size;
+    }
+    // Error handling: Size is wrong?
+    assert(buffer.size == size);
+    return static_cast<T *>(buffer.buffer);
+  }
+  template <typename T, typename Host_Allocator>
+  void mark_unused(T *p, const size_t size) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    auto buffer = std::find_if(
+        buffers.begin(), buffers.end(), [p](const pending_buffer &buffer) {
+          return buffer.buffer == static_cast<void *>(p);
+        });
+    assert(buffer != buffers.end());
+    assert(buffer->size == size);
+    // Last member done with it? Give it back to the top-level executor
+    if (++buffer->released == number_members) {
+      slice->parent.template mark_unused<T, Host_Allocator>(
+          p, size, buffer->ticket_index);
+      buffer->buffer = nullptr;
+    }
+  }
+
+  /// Closes the sub-batch and hands out the member slices once the
+  /// multi-slice is ready (and the sub-batch is full, if required)
+  void hand_out_if_ready(std::unique_lock<aggregation_mutex_t> &lock) {
+    if (closed || !slice.has_value() ||
+        (wait_until_full && member_promises.size() < capacity))
+      return;
+    closed = true;
+    number_members = member_promises.size();
+    alive_members = number_members;
+    assert(number_members <= slice->number_local_slices);
+    auto promises = std::move(member_promises);
+    // Hand out without holding the lock: the members directly continue with
+    // their calls
+    lock.unlock();
+    for (size_t member_id = 0; member_id < promises.size(); member_id++)
+      promises[member_id].set_value(
+          Sub_Batch_Slice{this->shared_from_this(), member_id});
+  }
+
+  /// The multi-slice could not be obtained: Closes the sub-batch and passes
+  /// the exception on to all members
+  void fail_members(std::unique_lock<aggregation_mutex_t> &lock,
+                    std::exception_ptr exception) {
+    closed = true;
+    auto promises = std::move(member_promises);
+    lock.unlock();
+    for (auto &promise : promises)
+      promise.set_exception(exception);
+  }
+
+  void member_done(void) {
+    std::lock_guard<aggregation_mutex_t> guard(mut);
+    assert(alive_members > 0);
+    // Last member: release the multi-slice
+    if (--alive_members == 0)
+      slice.reset();
+  }
+
+public:
+  /// wait_until_full: Hand out the member slices only once capacity members
+  /// joined (otherwise as soon as the multi-slice is ready)
+  aggregation_sub_batch(const size_t capacity, const bool wait_until_full)
+      : capacity(capacity), wait_until_full(wait_until_full) {}
+
+  /// Joins the sub-batch (empty optional if it is already full or closed)
+  std::optional<hpx::lcos::future<Sub_Batch_Slice>> join(void) {
+    std::unique_lock<aggregation_mutex_t> lock(mut);
+    if (closed || member_promises.size() == capacity)
+      return std::nullopt;
+    member_promises.emplace_back();
+    auto ret = member_promises.back().get_future();
+    hand_out_if_ready(lock);
+    return ret;
+  }
+  /// Takes part in the top-level aggregation with the given multi-slice
+  void start(hpx::lcos::future<Executor_Slice> &&multi_slice) {
+    multi_slice.then([batch = this->shared_from_this()](auto &&fut) {
+      std::unique_lock<aggregation_mutex_t> lock(batch->mut);
+      try {
+        batch->slice.emplace(fut.get());
+      } catch (...) {
+        batch->fail_members(lock, std::current_exception());
+        return;
+      }
+      batch->hand_out_if_ready(lock);
+    });
+  }
+};
+
+/// Two-level aggregation pool for large numbers of slices per launch
+/** Tasks aggregate into sub-batches of up to sub_batch_size slices first (one
+ * open sub-batch per group of worker threads). Each sub-batch takes part in
+ * the aggregation of the aggregation_pool<kernelname, ...> with a single
+ * multi-slice -- the top-level executors only see one request, call and
+ * buffer request per sub-batch instead of one per task.
+ */
+template <const char *kernelname, class Interface, class Pool>
+class hierarchical_aggregation_pool {
+public:
+  using top_level_pool = aggregation_pool<kernelname, Interface, Pool>;
+  using sub_batch_t = aggregation_sub_batch<Interface>;
+  using Sub_Batch_Slice = typename sub_batch_t::Sub_Batch_Slice;
+
+  /// Initializes the top-level pool -- slices_per_executor should be a
+  /// multiple of sub_batch_size
+  static void init(size_t number_of_executors, size_t slices_per_executor,
+                   Aggregated_Executor_Modes mode, size_t sub_batch_size,
+                   size_t number_of_worker_groups = 1) {
+    std::lock_guard<aggregation_mutex_t> guard(instance.init_mutex);
+    assert(instance.group_mutexes.empty());
+    assert(sub_batch_size >= 1 && sub_batch_size <= slices_per_executor);
+    // STRICT: Sub-batches wait until they are full -- only launches made up
+    // of full sub-batches can be complete
+    assert(mode != Aggregated_Executor_Modes::STRICT ||
+           slices_per_executor % sub_batch_size == 0);
+    assert(number_of_worker_groups >= 1);
+    top_level_pool::init(number_of_executors, slices_per_executor, mode);
+    instance.sub_batch_size = sub_batch_size;
+    instance.mode = mode;
+    instance.number_of_worker_groups = number_of_worker_groups;
+    for (size_t group = 0; group < number_of_worker_groups; group++) {
+      instance.group_mutexes.emplace_back();
+      instance.open_sub_batches.emplace_back();
+    }
+  }
+
+  static std::optional<hpx::lcos::future<Sub_Batch_Slice>>
+  request_executor_slice(void) {
+    const size_t group = get_worker_group();
+    std::lock_guard<aggregation_mutex_t> guard(instance.group_mutexes[group]);
+    auto &open_sub_batch = instance.open_sub_batches[group];
+    // Expected case: join the open sub-batch of this worker group
+    if (open_sub_batch) {
+      auto ret = open_sub_batch->join();
+      if (ret.has_value())
+        return ret;
+    }
+    // Full or already started: Open a new sub-batch with its multi-slice
+    auto multi_slice =
+        top_level_pool::request_executor_slices(instance.sub_batch_size);
+    if (!multi_slice.has_value())
+      return std::nullopt;
+    open_sub_batch = std::make_shared<sub_batch_t>(
+        instance.sub_batch_size,
+        instance.mode == Aggregated_Executor_Modes::STRICT);
+    auto ret = open_sub_batch->join();
+    open_sub_batch->start(std::move(multi_slice.value()));
+    return ret;
+  }
+
+private:
+  size_t sub_batch_size{1};
+  Aggregated_Executor_Modes mode{Aggregated_Executor_Modes::EAGER};
+  size_t number_of_worker_groups{1};
+  /// Open sub-batch (and its mutex) per worker group
+  std::deque<aggregation_mutex_t> group_mutexes;
+  std::deque<std::shared_ptr<sub_batch_t>> open_sub_batches;
+  aggregation_mutex_t init_mutex;
+
+  /// Worker group of the current worker thread
+  static size_t get_worker_group(void) {
+    if (instance.number_of_worker_groups == 1)
+      return 0;
+    const size_t worker_id = hpx::get_worker_thread_num();
+    // Threads outside of the HPX worker pool always use the first group
+    if (worker_id == static_cast<size_t>(-1))
+      return 0;
+    return std::min(worker_id * instance.number_of_worker_groups /
+                        hpx::get_num_worker_threads(),
+                    instance.number_of_worker_groups - 1);
+  }
+
+  static inline hierarchical_aggregation_pool instance{};
+  hierarchical_aggregation_pool() = default;
+
+public:
+  ~hierarchical_aggregation_pool() = default;
+  // Bunch of constructors we don't need
+  hierarchical_aggregation_pool(hierarchical_aggregation_pool const &other) =
+      delete;
+  hierarchical_aggregation_pool &
+  operator=(hierarchical_aggregation_pool const &other) = delete;
+  hierarchical_aggregation_pool(hierarchical_aggregation_pool &&other) =
+      delete;
+  hierarchical_aggregation_pool &
+  operator=(hierarchical_aggregation_pool &&other) = delete;
+};
+
+//===============================================================================
+//===============================================================================
+// Kernel fusion across pools:
+
+/// Pool name of a composite of kernels (given by the kernel names of their
+/// aggregation pools): Each combination of kernel names yields its own name
+/// (the address of name differs per instantiation) and thus its own pool
+template <const char *... kernelnames> struct composite_kernelname {
+  static_assert(sizeof...(kernelnames) > 1,
+                "A composite needs at least two kernels");
+  static constexpr const char name[] = "composite_kernel";
+};
+
+/// Plain aggregation_pool of its own for a composite of kernels that tasks
+/// call back to back with Executor_Slice::fused_async (one aggregated launch
+/// for all kernels of all slices)
+/** The kernel names only identify the pool: Nothing gets registered with the
+ * aggregation pools of the individual kernels -- this pool has to be
+ * initialized on its own and its executors and slices are never shared with
+ * the pools of the individual kernels.
+ */
+template <class Interface, class Pool, const char *... kernelnames>
+using composite_kernel_pool =
+    aggregation_pool<composite_kernelname<kernelnames...>::name, Interface,
+                     Pool>;
+
 #endif
@@ -0,0 +1,249 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef ARENA_BUFFER_UTIL_HPP
+#define ARENA_BUFFER_UTIL_HPP
+
+#include "buffer_manager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace recycler {
+namespace detail {
+
+/// Buddy sub-allocator on top of the large blocks of one underlying allocator
+/** All bookkeeping lives on the host, the blocks are never touched (they may
+ * be device memory). Sub-allocations are powers of two (multiples of
+ * min_size) within one block, freed sub-allocations get merged with their
+ * buddies again. Blocks that become completely unused go back to the
+ * underlying allocator right away: Below a recycler, buffers only get back
+ * here upon cleanup. Requests larger than block_size get dedicated
+ * allocations from the underlying allocator.
+ */
+template <typename Byte_Allocator, size_t block_size, size_t min_size>
+class buddy_arena {
+private:
+  static_assert(min_size > 0 && (min_size & (min_size - 1)) == 0,
+                "min_size of the arena needs to be a power of two");
+  static_assert(block_size >= min_size &&
+                    (block_size & (block_size - 1)) == 0,
+                "block_size of the arena needs to be a power of two");
+  static constexpr size_t order_of(size_t size) {
+    size_t order = 0;
+    while ((min_size << order) < size)
+      order++;
+    return order;
+  }
+  static constexpr size_t max_order = order_of(block_size);
+
+  std::mutex mut;
+  /// Blocks of the underlying allocator (by their start)
+  std::set<char *> blocks{};
+  /// Unused sub-allocations of each order (size min_size << order)
+  std::array<std::set<char *>, max_order + 1> free_lists{};
+  /// Sub-allocations in use and their order
+  std::unordered_map<char *, size_t> used{};
+  /// Dedicated allocations (larger than block_size) and their size
+  std::unordered_map<char *, size_t> dedicated{};
+  size_t number_block_allocations{0};
+  /// Device the blocks belong to (if the underlying allocator tells)
+  std::optional<size_t> device_id{};
+
+  buddy_arena() = default;
+
+public:
+  /// Leaked on purpose: the buffer managers may still free buffers during
+  /// static destruction
+  static buddy_arena &instance(void) {
+    static buddy_arena *arena = new buddy_arena{};
+    return *arena;
+  }
+
+  void *allocate(const size_t bytes) {
+    std::lock_guard<std::mutex> guard(mut);
+    if (bytes > block_size) {
+      char *data = Byte_Allocator{}.allocate(bytes);
+      dedicated.emplace(data, bytes);
+      number_block_allocations++;
+      return data;
+    }
+    const size_t order = order_of(bytes);
+    size_t available_order = order;
+    while (available_order <= max_order && free_lists[available_order].empty())
+      available_order++;
+    if (available_order > max_order) {
+      char *block = Byte_Allocator{}.allocate(block_size);
+      blocks.insert(block);
+      free_lists[max_order].insert(block);
+      available_order = max_order;
+      number_block_allocations++;
+    }
+    char *data = *free_lists[available_order].begin();
+    free_lists[available_order].erase(free_lists[available_order].begin());
+    // Split until the sub-allocation fits -- upper halves stay free
+    while (available_order > order) {
+      available_order--;
+      free_lists[available_order].insert(data +
+                                         (min_size << available_order));
+    }
+    used.emplace(data, order);
+    return data;
+  }
+
+  void deallocate(void *p, const size_t bytes) {
+    std::lock_guard<std::mutex> guard(mut);
+    char *data = static_cast<char *>(p);
+    if (bytes > block_size) {
+      auto entry = dedicated.find(data);
+      assert(entry != dedicated.end());
+      Byte_Allocator{}.deallocate(data, entry->second);
+      dedicated.erase(entry);
+      return;
+    }
+    auto entry = used.find(data);
+    assert(entry != used.end());
+    size_t order = entry->second;
+    used.erase(entry);
+    char *block = *std::prev(blocks.upper_bound(data));
+    // Merge with the buddies as long as they are free as well
+    while (order < max_order) {
+      char *buddy = block + ((data - block) ^ (min_size << order));
+      auto free_buddy = free_lists[order].find(buddy);
+      if (free_buddy == free_lists[order].end())
+        break;
+      free_lists[order].erase(free_buddy);
+      data = std::min(data, buddy);
+      order++;
+    }
+    if (order == max_order) {
+      assert(data == block);
+      blocks.erase(block);
+      Byte_Allocator{}.deallocate(block, block_size);
+    } else {
+      free_lists[order].insert(data);
+    }
+  }
+
+  /// Arenas are single-device: Throws if a request comes from another device
+  /// than the first one
+  void check_device(const size_t requesting_device_id) {
+    std::lock_guard<std::mutex> guard(mut);
+    if (!device_id) {
+      device_id = requesting_device_id;
+    } else if (device_id.value() != requesting_device_id) {
+      throw std::runtime_error(
+          "buddy_arena: Requested on device " +
+          std::to_string(requesting_device_id) + " while used on device " +
+          std::to_string(device_id.value()) +
+          " (arenas only support one device)");
+    }
+  }
+
+  /// Blocks (and dedicated allocations) currently held
+  size_t get_number_blocks(void) {
+    std::lock_guard<std::mutex> guard(mut);
+    return blocks.size() + dedicated.size();
+  }
+  /// Allocations requested from the underlying allocator so far
+  size_t get_number_block_allocations(void) {
+    std::lock_guard<std::mutex> guard(mut);
+    return number_block_allocations;
+  }
+
+  buddy_arena(buddy_arena const &other) = delete;
+  buddy_arena &operator=(buddy_arena const &other) = delete;
+  buddy_arena(buddy_arena &&other) = delete;
+  buddy_arena &operator=(buddy_arena &&other) = delete;
+};
+
+/// Does the allocator tell the device its allocations go to (get_device_id)?
+template <typename Allocator, typename = void>
+struct has_device_id : std::false_type {};
+template <typename Allocator>
+struct has_device_id<Allocator,
+                     std::void_t<decltype(Allocator::get_device_id())>>
+    : std::true_type {};
+
+/// Host_Allocator adaptor sub-allocating the blocks of Underlying_Allocator
+/// (for instance cuda_device_allocator, hip_device_allocator or
+/// sycl_device_default_allocator) -- see buddy_arena
+/** All arena_allocators with the same underlying allocator (regardless of
+ * their value type) share one arena. Sub-allocations are aligned to min_size
+ * within the blocks (device allocations are at least 256 byte aligned).
+ * Single-device only: With underlying allocators providing get_device_id
+ * (like cuda_device_allocator), requests from another device throw.
+ */
+template <typename T, typename Underlying_Allocator,
+          size_t block_size = size_t{1} << 26, size_t min_size = 256>
+struct arena_allocator {
+  using value_type = T;
+  using byte_allocator_t = typename std::allocator_traits<
+      Underlying_Allocator>::template rebind_alloc<char>;
+  using arena_t = buddy_arena<byte_allocator_t, block_size, min_size>;
+
+  arena_allocator() noexcept = default;
+  template <typename U, typename Other_Allocator>
+  explicit arena_allocator(
+      arena_allocator<U, Other_Allocator, block_size, min_size> const
+          &) noexcept {}
+  T *allocate(std::size_t n) {
+    if constexpr (has_device_id<Underlying_Allocator>::value)
+      arena_t::instance().check_device(Underlying_Allocator::get_device_id());
+    return static_cast<T *>(arena_t::instance().allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t n) {
+    arena_t::instance().deallocate(p, n * sizeof(T));
+  }
+
+  static size_t get_number_blocks(void) {
+    return arena_t::instance().get_number_blocks();
+  }
+  static size_t get_number_block_allocations(void) {
+    return arena_t::instance().get_number_block_allocations();
+  }
+};
+template <class T, class U, class Underlying_Allocator, size_t block_size,
+          size_t min_size>
+constexpr bool operator==(
+    arena_allocator<T, Underlying_Allocator, block_size, min_size> const &,
+    arena_allocator<U, Underlying_Allocator, block_size, min_size> const
+        &) noexcept {
+  return true;
+}
+template <class T, class U, class Underlying_Allocator, size_t block_size,
+          size_t min_size>
+constexpr bool operator!=(
+    arena_allocator<T, Underlying_Allocator, block_size, min_size> const &,
+    arena_allocator<U, Underlying_Allocator, block_size, min_size> const
+        &) noexcept {
+  return false;
+}
+
+} // end namespace detail
+
+/// Recycled buffers sub-allocated from large blocks of Underlying_Allocator,
+/// e.g. recycle_allocator_arena<double, detail::cuda_device_allocator<double>>
+/// -- for one device only (see arena_allocator)
+template <typename T, typename Underlying_Allocator,
+          std::enable_if_t<std::is_trivial<T>::value, int> = 0>
+using recycle_allocator_arena =
+    detail::recycle_allocator<T,
+                              detail::arena_allocator<T, Underlying_Allocator>>;
+
+} // end namespace recycler
+
+#endif
@@ -8,6 +8,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <list>
@@ -17,6 +18,7 @@
 #include <stdexcept>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 // Warn about suboptimal performance without correct HPX-aware allocators
 #ifdef CPPUDDLE_HAVE_HPX
@@ -28,6 +30,8 @@ For better performance configure CPPuddle with the cmake option CPPUDDLE_WITH_HP
 // include runtime to get HPX thread IDs required for the HPX-aware allocators
 #include <hpx/include/runtime.hpp>
 #endif
+// futures for the deferred release of buffers (release_after)
+#include <hpx/futures/future.hpp>
 #endif
 
 #if defined(CPPUDDLE_HAVE_HPX) && defined(CPPUDDLE_HAVE_HPX_MUTEX)
@@ -43,15 +47,164 @@ namespace recycler {
 constexpr size_t number_instances = 128;
 namespace detail {
 
+/// Intrusive reference counter of the views of a buffer (see recycled_view)
+/** Allocated once per buffer by the buffer_manager and kept with it while it
+ * gets recycled (no allocation per view). Counts both the view handles (lower
+ * half) and the allocations of the buffer still to be released (upper half,
+ * without the top bit) within one atomic word: the last view handle takes
+ * over releasing all outstanding allocations. Detached counters (top bit)
+ * belong to their views: the last view handle deletes them. Allocators
+ * without buffer metadata use counters that are detached from the start,
+ * the buffer_manager detaches the counters of buffers still viewed when it
+ * gets cleaned up.
+ */
+class view_reference_counter {
+private:
+  static constexpr uint64_t handle = 1;
+  static constexpr uint64_t allocation = uint64_t{1} << 32;
+  static constexpr uint64_t detached_flag = uint64_t{1} << 63;
+  static constexpr uint64_t handle_mask = allocation - 1;
+  std::atomic<uint64_t> state{0};
+
+public:
+  view_reference_counter(void) = default;
+  explicit view_reference_counter(const bool detached)
+      : state(detached ? detached_flag : 0) {}
+  view_reference_counter(const view_reference_counter &other) = delete;
+  view_reference_counter &
+  operator=(const view_reference_counter &other) = delete;
+
+  /// No views left (and no allocations to release)?
+  bool unused(void) const { return (state.load() & ~detached_flag) == 0; }
+  /// New view owning one allocation of the buffer
+  void add_allocation(void) {
+    state.fetch_add(allocation + handle, std::memory_order_relaxed);
+  }
+  /// New view (copy) of the buffer
+  void add_handle(void) { state.fetch_add(handle, std::memory_order_relaxed); }
+  /// Drops a view handle -- returns the number of allocations the caller has
+  /// to release if this was the last handle (0 otherwise). delete_counter is
+  /// set if the caller has to delete the (detached) counter as well
+  size_t release_handle(bool &delete_counter) {
+    uint64_t current = state.load(std::memory_order_relaxed);
+    while (true) {
+      assert((current & handle_mask) > 0);
+      const bool last_handle = (current & handle_mask) == handle;
+      const uint64_t next = last_handle ? 0 : current - handle;
+      if (state.compare_exchange_weak(current, next,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_relaxed)) {
+        delete_counter = last_handle && (current & detached_flag) != 0;
+        return last_handle ? static_cast<size_t>((current & ~detached_flag) /
+                                                 allocation)
+                           : 0;
+      }
+    }
+  }
+  /// Hands the counter over to its views -- returns false if there are none
+  /// (the caller deletes the counter then)
+  bool detach(void) {
+    return (state.fetch_or(detached_flag) & handle_mask) != 0;
+  }
+};
+
+/// Stream (executor) a buffer was last released on, together with the
+/// completion of the work still using it
+/** Stream ordering makes such buffers reusable right away for more work on
+ * the same stream. Requests for other streams (or without any stream) only
+ * get them once their completion is ready.
+ */
+struct stream_affinity {
+  const void *stream{nullptr};
+#ifdef CPPUDDLE_HAVE_HPX
+  hpx::shared_future<void> completion{};
+#endif
+
+  /// Is the work of the last stream done (or was there none)?
+  bool completed(void) const {
+#ifdef CPPUDDLE_HAVE_HPX
+    return !completion.valid() || completion.is_ready();
+#else
+    return true;
+#endif
+  }
+  /// Can work on requesting_stream (nullptr for none) use the buffer now?
+  bool reusable_on(const void *requesting_stream) const {
+    return (stream != nullptr && stream == requesting_stream) || completed();
+  }
+  /// Blocks until the buffer is not used by its last stream anymore (only
+  /// for the cleanup of the buffers)
+  void wait(void) const {
+#ifdef CPPUDDLE_HAVE_HPX
+    if (completion.valid())
+      completion.wait();
+#endif
+  }
+};
+
+/// Does the executor expose the handle of its stream (get_stream)?
+template <typename Executor, typename = void>
+struct has_stream_handle : std::false_type {};
+template <typename Executor>
+struct has_stream_handle<
+    Executor,
+    std::void_t<decltype(std::declval<const Executor &>().get_stream())>>
+    : std::true_type {};
+
+/// Identifies the stream of executor in a stream_affinity
+/** Uses the underlying stream handle instead of the executor object: Copies
+ * of an executor (and executors moved from it) keep the identity of the
+ * stream. The handle has to be pointer-like (e.g. cudaStream_t).
+ */
+template <typename Executor>
+const void *stream_handle(const Executor &executor) {
+  static_assert(has_stream_handle<Executor>::value,
+                "Stream-ordered recycling requires executors with get_stream()");
+  const auto stream = executor.get_stream();
+  static_assert(std::is_pointer_v<std::decay_t<decltype(stream)>>,
+                "get_stream() has to return a pointer-like stream handle");
+  return static_cast<const void *>(stream);
+}
+
+/// Location (of the buffer managers) new buffers get requested at -- the same
+/// one for all allocation functions of the recycle allocators
+inline std::optional<size_t> allocation_location(void) {
+#ifdef CPPUDDLE_HAVE_HPX_AWARE_ALLOCATORS
+  return hpx::get_worker_thread_num();
+#else
+  return std::nullopt;
+#endif
+}
+
 #if defined(CPPUDDLE_HAVE_HPX) && defined(CPPUDDLE_HAVE_HPX_MUTEX)
 using mutex_t = hpx::spinlock;
 #else
 using mutex_t = std::mutex;
 #endif
 
+class simulated_device;
+
 class buffer_recycler {
+  /// Stops its device threads upon cleanup (see add_total_cleanup_callback)
+  friend class simulated_device;
+
   // Public interface
 public:
+#ifdef CPPUDDLE_HAVE_COUNTERS
+  /// Counters of the buffers of one type (summed over all locations, reset
+  /// with each cleanup, all zero without recycling)
+  struct statistics {
+    size_t number_allocation{0};
+    size_t number_recycling{0};
+    size_t number_creation{0};
+    size_t number_contended_locks{0};
+  };
+  template <typename T, typename Host_Allocator>
+  static statistics get_statistics(void) {
+    return buffer_manager<T, Host_Allocator>::get_statistics();
+  }
+#endif
+
 #if defined(CPPUDDLE_DEACTIVATE_BUFFER_RECYCLING)
 
 // Warn about suboptimal performance without recycling
@@ -61,29 +214,55 @@ For better performance configure CPPuddle with the cmake option CPPUDDLE_DEACTIV
 
   template <typename T, typename Host_Allocator>
   static T *get(size_t number_elements, bool manage_content_lifetime = false,
-      std::optional<size_t> location_hint = std::nullopt) {
+      std::optional<size_t> location_hint = std::nullopt,
+      view_reference_counter **reference_counter = nullptr,
+      const void *stream = nullptr) {
+    // No buffer metadata without recycling
+    if (reference_counter)
+      *reference_counter = nullptr;
     return Host_Allocator{}.allocate(number_elements);
   }
   /// Marks an buffer as unused and fit for reusage
   template <typename T, typename Host_Allocator>
   static void mark_unused(T *p, size_t number_elements,
-      std::optional<size_t> location_hint = std::nullopt) {
+      std::optional<size_t> location_hint = std::nullopt,
+      const stream_affinity &affinity = {}) {
+#ifdef CPPUDDLE_HAVE_HPX
+    // No stream-ordered reuse without recycling: Free the buffer once the
+    // stream is done with it (without blocking)
+    if (!affinity.completed()) {
+      affinity.completion.then([p, number_elements](auto &&) {
+        Host_Allocator{}.deallocate(p, number_elements);
+      });
+      return;
+    }
+#endif
     return Host_Allocator{}.deallocate(p, number_elements);
   }
 #else
   /// Returns and allocated buffer of the requested size - this may be a reused
   /// buffer
+  /// reference_counter (optional) returns the view reference counter in the
+  /// metadata of the buffer -- valid until the buffer is marked as unused
+  /// stream (optional) identifies the stream the buffer is requested for:
+  /// buffers last released on it are preferred (see stream_affinity)
   template <typename T, typename Host_Allocator>
   static T *get(size_t number_elements, bool manage_content_lifetime = false,
-      std::optional<size_t> location_hint = std::nullopt) {
-    return buffer_manager<T, Host_Allocator>::get(number_elements,
-                                                  manage_content_lifetime, location_hint);
+      std::optional<size_t> location_hint = std::nullopt,
+      view_reference_counter **reference_counter = nullptr,
+      const void *stream = nullptr) {
+    return buffer_manager<T, Host_Allocator>::get(
+        number_elements, manage_content_lifetime, location_hint,
+        reference_counter, stream);
   }
   /// Marks an buffer as unused and fit for reusage
+  /// affinity (optional) tags the buffer with the stream still using it
   template <typename T, typename Host_Allocator>
   static void mark_unused(T *p, size_t number_elements,
-      std::optional<size_t> location_hint = std::nullopt) {
-    return buffer_manager<T, Host_Allocator>::mark_unused(p, number_elements);
+      std::optional<size_t> location_hint = std::nullopt,
+      const stream_affinity &affinity = {}) {
+    return buffer_manager<T, Host_Allocator>::mark_unused(
+        p, number_elements, location_hint, affinity);
   }
 #endif
   /// Deallocate all buffers, no matter whether they are marked as used or not
@@ -159,26 +338,37 @@ private:
   /// Memory Manager subclass to handle buffers a specific type
   template <typename T, typename Host_Allocator> class buffer_manager {
   private:
-    // Tuple content: Pointer to buffer, buffer_size, location ID, Flag
-    // The flag at the end controls whether to buffer content is to be reused as
-    // well
-    using buffer_entry_type = std::tuple<T *, size_t, size_t, bool>;
+    // Tuple content: Pointer to buffer, buffer_size, view reference counter
+    // (owned by the entry), Flag, stream affinity. The flag controls whether
+    // to buffer content is to be reused as well, the stream affinity is only
+    // set for unused buffers
+    using buffer_entry_type =
+        std::tuple<T *, size_t, view_reference_counter *, bool,
+                   stream_affinity>;
 
   public:
     /// Cleanup and delete this singleton
     static void clean() {
       assert(instance() && !is_finalized);
       for (auto i = 0; i < number_instances; i++) {
-        std::lock_guard<mutex_t> guard(instance()[i].mut);
-        instance()[i].clean_all_buffers();
+        std::list<buffer_entry_type> unused_buffers;
+        {
+          std::lock_guard<mutex_t> guard(instance()[i].mut);
+          unused_buffers = instance()[i].clean_all_buffers();
+        }
+        release_unused_buffers(unused_buffers);
       }
     }
     static void finalize() {
       assert(instance() && !is_finalized);
       is_finalized = true;
       for (auto i = 0; i < number_instances; i++) {
-        std::lock_guard<mutex_t> guard(instance()[i].mut);
-        instance()[i].clean_all_buffers();
+        std::list<buffer_entry_type> unused_buffers;
+        {
+          std::lock_guard<mutex_t> guard(instance()[i].mut);
+          unused_buffers = instance()[i].clean_all_buffers();
+        }
+        release_unused_buffers(unused_buffers);
       }
       instance().reset();
     }
@@ -186,21 +376,53 @@ private:
     static void clean_unused_buffers_only() {
       assert(instance() && !is_finalized);
       for (auto i = 0; i < number_instances; i++) {
-        std::lock_guard<mutex_t> guard(instance()[i].mut);
-        for (auto &buffer_tuple : instance()[i].unused_buffer_list) {
-          Host_Allocator alloc;
-          if (std::get<3>(buffer_tuple)) {
-            std::destroy_n(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
-          }
-          alloc.deallocate(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
+        std::list<buffer_entry_type> unused_buffers;
+        {
+          std::lock_guard<mutex_t> guard(instance()[i].mut);
+          unused_buffers.splice(unused_buffers.end(),
+                                instance()[i].unused_buffer_list);
+          instance()[i].spare_map_nodes.clear();
+          instance()[i].spare_list_nodes.clear();
+        }
+        release_unused_buffers(unused_buffers);
+      }
+    }
+    /// Frees buffers taken out of an unused_buffer_list -- not while holding
+    /// the location lock: Waiting for the last stream of a buffer may require
+    /// work that uses this location as well
+    static void release_unused_buffers(std::list<buffer_entry_type> &buffers) {
+      for (auto &buffer_tuple : buffers) {
+        Host_Allocator alloc;
+        std::get<4>(buffer_tuple).wait(); // still used by its last stream?
+        if (std::get<3>(buffer_tuple)) {
+          std::destroy_n(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
         }
-        instance()[i].unused_buffer_list.clear();
+        alloc.deallocate(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
+        delete std::get<2>(buffer_tuple);
+      }
+      buffers.clear();
+    }
+
+#ifdef CPPUDDLE_HAVE_COUNTERS
+    static statistics get_statistics(void) {
+      assert(instance() && !is_finalized);
+      statistics stats{};
+      for (size_t i = 0; i < number_instances; i++) {
+        std::lock_guard<mutex_t> guard(instance()[i].mut);
+        stats.number_allocation += instance()[i].number_allocation;
+        stats.number_recycling += instance()[i].number_recycling;
+        stats.number_creation += instance()[i].number_creation;
+        stats.number_contended_locks += instance()[i].number_contended_locks;
       }
+      return stats;
     }
+#endif
 
     /// Tries to recycle or create a buffer of type T and size number_elements.
     static T *get(size_t number_of_elements, bool manage_content_lifetime,
-        std::optional<size_t> location_hint = std::nullopt) {
+        std::optional<size_t> location_hint = std::nullopt,
+        view_reference_counter **reference_counter = nullptr,
+        const void *stream = nullptr) {
       init_callbacks_once();
       if (is_finalized) {
         throw std::runtime_error("Tried allocation after finalization");
@@ -209,46 +431,74 @@ private:
 
       size_t location_id = 0;
       if (location_hint) {
-        location_id = location_hint.value();
+        location_id = location_hint.value() % number_instances;
       }
-      std::lock_guard<mutex_t> guard(instance()[location_id].mut);
+      auto guard = lock_location(location_id);
 
 
 #ifdef CPPUDDLE_HAVE_COUNTERS
       instance()[location_id].number_allocation++;
 #endif
-      // Check for unused buffers we can recycle:
-      for (auto iter = instance()[location_id].unused_buffer_list.begin();
-           iter != instance()[location_id].unused_buffer_list.end(); iter++) {
-        auto tuple = *iter;
-        if (std::get<1>(tuple) == number_of_elements) {
-          instance()[location_id].unused_buffer_list.erase(iter);
-
-          // handle the switch from aggressive to non aggressive reusage (or
-          // vice-versa)
-          if (manage_content_lifetime && !std::get<3>(tuple)) {
-            std::uninitialized_value_construct_n(std::get<0>(tuple),
-                                                  number_of_elements);
-            std::get<3>(tuple) = true;
-          } else if (!manage_content_lifetime && std::get<3>(tuple)) {
-            std::destroy_n(std::get<0>(tuple), std::get<1>(tuple));
-            std::get<3>(tuple) = false;
-          }
-          instance()[location_id].buffer_map.insert({std::get<0>(tuple), tuple});
+      // Check for unused buffers we can recycle: Buffers of the requesting
+      // stream first, otherwise the first one not in use by another stream
+      auto &unused_buffer_list = instance()[location_id].unused_buffer_list;
+      auto recycled = unused_buffer_list.end();
+      for (auto iter = unused_buffer_list.begin();
+           iter != unused_buffer_list.end(); iter++) {
+        if (std::get<1>(*iter) != number_of_elements)
+          continue;
+        const stream_affinity &affinity = std::get<4>(*iter);
+        // (switching the content lifetime touches the content: not while
+        // the stream may still use it)
+        if (stream != nullptr && affinity.stream == stream &&
+            std::get<3>(*iter) == manage_content_lifetime) {
+          recycled = iter;
+          break;
+        }
+        if (recycled == unused_buffer_list.end() && affinity.completed()) {
+          recycled = iter;
+          if (stream == nullptr)
+            break;
+        }
+      }
+      if (recycled != unused_buffer_list.end()) {
+        // The new user of the buffer takes over the ordering with its stream
+        std::get<4>(*recycled) = stream_affinity{};
+        auto tuple = *recycled;
+        // Keep the list node for the next unused buffer
+        instance()[location_id].spare_list_nodes.splice(
+            instance()[location_id].spare_list_nodes.begin(),
+            unused_buffer_list, recycled);
+
+        // handle the switch from aggressive to non aggressive reusage (or
+        // vice-versa)
+        if (manage_content_lifetime && !std::get<3>(tuple)) {
+          std::uninitialized_value_construct_n(std::get<0>(tuple),
+                                                number_of_elements);
+          std::get<3>(tuple) = true;
+        } else if (!manage_content_lifetime && std::get<3>(tuple)) {
+          std::destroy_n(std::get<0>(tuple), std::get<1>(tuple));
+          std::get<3>(tuple) = false;
+        }
+        auto entry = instance()[location_id].insert_used_buffer(tuple);
+        if (reference_counter)
+          *reference_counter = std::get<2>(entry->second);
 #ifdef CPPUDDLE_HAVE_COUNTERS
-          instance()[location_id].number_recycling++;
+        instance()[location_id].number_recycling++;
 #endif
-          return std::get<0>(tuple);
-        }
+        return std::get<0>(tuple);
       }
 
       // No unused buffer found -> Create new one and return it
       try {
         Host_Allocator alloc;
         T *buffer = alloc.allocate(number_of_elements);
-        instance()[location_id].buffer_map.insert(
-            {buffer, std::make_tuple(buffer, number_of_elements, 1,
-                                     manage_content_lifetime)});
+        auto entry = instance()[location_id].insert_used_buffer(
+            std::make_tuple(buffer, number_of_elements,
+                            new view_reference_counter{},
+                            manage_content_lifetime, stream_affinity{}));
+        if (reference_counter)
+          *reference_counter = std::get<2>(entry->second);
 #ifdef CPPUDDLE_HAVE_COUNTERS
         instance()[location_id].number_creation++;
 #endif
@@ -266,9 +516,12 @@ private:
         // We've done all we can in here
         Host_Allocator alloc;
         T *buffer = alloc.allocate(number_of_elements);
-        instance()[location_id].buffer_map.insert(
-            {buffer, std::make_tuple(buffer, number_of_elements, 1,
-                                     manage_content_lifetime)});
+        auto entry = instance()[location_id].insert_used_buffer(
+            std::make_tuple(buffer, number_of_elements,
+                            new view_reference_counter{},
+                            manage_content_lifetime, stream_affinity{}));
+        if (reference_counter)
+          *reference_counter = std::get<2>(entry->second);
 #ifdef CPPUDDLE_HAVE_COUNTERS
         instance()[location_id].number_creation++;
         instance()[location_id].number_bad_alloc++;
@@ -282,14 +535,15 @@ private:
     }
 
     static void mark_unused(T *memory_location, size_t number_of_elements,
-        std::optional<size_t> location_hint = std::nullopt) {
+        std::optional<size_t> location_hint = std::nullopt,
+        const stream_affinity &affinity = {}) {
       if (is_finalized)
         return;
       assert(instance() && !is_finalized);
 
       if (location_hint) {
-        size_t location_id = location_hint.value();
-        std::lock_guard<mutex_t> guard(instance()[location_id].mut);
+        size_t location_id = location_hint.value() % number_instances;
+        auto guard = lock_location(location_id);
         if (instance()[location_id].buffer_map.find(memory_location) !=
             instance()[location_id].buffer_map.end()) {
 #ifdef CPPUDDLE_HAVE_COUNTERS
@@ -297,12 +551,10 @@ private:
 #endif
           auto it = instance()[location_id].buffer_map.find(memory_location);
           assert(it != instance()[location_id].buffer_map.end());
-          auto &tuple = it->second;
           // sanity checks:
-          assert(std::get<1>(tuple) == number_of_elements);
+          assert(std::get<1>(it->second) == number_of_elements);
           // move to the unused_buffer list
-          instance()[location_id].unused_buffer_list.push_front(tuple);
-          instance()[location_id].buffer_map.erase(memory_location);
+          instance()[location_id].insert_unused_buffer(it, affinity);
           return; // Success
         }
         // hint was wrong - note that, and continue on with all other buffer
@@ -314,7 +566,7 @@ private:
 
       for(size_t location_id = 0; location_id < number_instances; location_id++) {
         if (location_hint) {
-           if (location_hint.value() == location_id) {
+           if (location_hint.value() % number_instances == location_id) {
              continue; // already tried this -> skip
            }
         }
@@ -326,12 +578,10 @@ private:
 #endif
           auto it = instance()[location_id].buffer_map.find(memory_location);
           assert(it != instance()[location_id].buffer_map.end());
-          auto &tuple = it->second;
           // sanity checks:
-          assert(std::get<1>(tuple) == number_of_elements);
+          assert(std::get<1>(it->second) == number_of_elements);
           // move to the unused_buffer list
-          instance()[location_id].unused_buffer_list.push_front(tuple);
-          instance()[location_id].buffer_map.erase(memory_location);
+          instance()[location_id].insert_unused_buffer(it, affinity);
           return; // Success
         }
       }
@@ -351,17 +601,38 @@ private:
     }
 
   private:
+    using buffer_map_type = std::unordered_map<T *, buffer_entry_type>;
     /// List with all buffers still in usage
-    std::unordered_map<T *, buffer_entry_type> buffer_map{};
+    buffer_map_type buffer_map{};
     /// List with all buffers currently not used
     std::list<buffer_entry_type> unused_buffer_list{};
+    /// Nodes of the two containers above that are currently not needed --
+    /// reused when buffers change between them: Recycling a buffer does not
+    /// allocate any bookkeeping memory once all nodes exist
+    std::vector<typename buffer_map_type::node_type> spare_map_nodes{};
+    std::list<buffer_entry_type> spare_list_nodes{};
     /// Access control
     mutex_t mut;
 #ifdef CPPUDDLE_HAVE_COUNTERS
     /// Performance counters
     size_t number_allocation{0}, number_dealloacation{0}, number_wrong_hints{0};
     size_t number_recycling{0}, number_creation{0}, number_bad_alloc{0};
+    size_t number_contended_locks{0};
 #endif
+    /// Locks the given location (and counts if it was already locked)
+    static std::unique_lock<mutex_t> lock_location(const size_t location_id) {
+#ifdef CPPUDDLE_HAVE_COUNTERS
+      std::unique_lock<mutex_t> guard(instance()[location_id].mut,
+                                      std::try_to_lock);
+      if (!guard.owns_lock()) {
+        guard.lock();
+        instance()[location_id].number_contended_locks++;
+      }
+      return guard;
+#else
+      return std::unique_lock<mutex_t>(instance()[location_id].mut);
+#endif
+    }
     /// default, private constructor - not automatically constructed due to the
     /// deleted constructors
     buffer_manager() = default;
@@ -394,22 +665,47 @@ private:
     }
     static inline std::atomic<bool> is_finalized;
 
+    /// Adds a buffer to the buffer_map (with a spare node if there is one)
+    typename buffer_map_type::iterator
+    insert_used_buffer(const buffer_entry_type &buffer_tuple) {
+      if (spare_map_nodes.empty())
+        return buffer_map.insert({std::get<0>(buffer_tuple), buffer_tuple})
+            .first;
+      auto node = std::move(spare_map_nodes.back());
+      spare_map_nodes.pop_back();
+      node.key() = std::get<0>(buffer_tuple);
+      node.mapped() = buffer_tuple;
+      auto result = buffer_map.insert(std::move(node));
+      assert(result.inserted);
+      return result.position;
+    }
+    /// Moves a buffer from the buffer_map to the unused_buffer_list (with a
+    /// spare node if there is one) and keeps its map node as spare node
+    void insert_unused_buffer(typename buffer_map_type::iterator it,
+                              const stream_affinity &affinity) {
+      if (spare_list_nodes.empty()) {
+        unused_buffer_list.push_front(it->second);
+      } else {
+        unused_buffer_list.splice(unused_buffer_list.begin(), spare_list_nodes,
+                                  spare_list_nodes.begin());
+        unused_buffer_list.front() = it->second;
+      }
+      std::get<4>(unused_buffer_list.front()) = affinity;
+      spare_map_nodes.push_back(buffer_map.extract(it));
+    }
+
 
-    void clean_all_buffers(void) {
+    /// Frees the buffers in use and returns the unused ones -- to be freed
+    /// with release_unused_buffers after releasing the location lock
+    std::list<buffer_entry_type> clean_all_buffers(void) {
+      std::list<buffer_entry_type> unused_buffers;
 #ifdef CPPUDDLE_HAVE_COUNTERS
       if (number_allocation == 0 && number_recycling == 0 &&
           number_bad_alloc == 0 && number_creation == 0 &&
           unused_buffer_list.empty() && buffer_map.empty()) {
-        return;
+        return unused_buffers;
       }
 #endif
-      for (auto &buffer_tuple : unused_buffer_list) {
-        Host_Allocator alloc;
-        if (std::get<3>(buffer_tuple)) {
-          std::destroy_n(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
-        }
-        alloc.deallocate(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
-      }
       for (auto &map_tuple : buffer_map) {
         auto buffer_tuple = map_tuple.second;
         Host_Allocator alloc;
@@ -417,6 +713,10 @@ private:
           std::destroy_n(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
         }
         alloc.deallocate(std::get<0>(buffer_tuple), std::get<1>(buffer_tuple));
+        // Views still referencing the buffer need its view reference counter
+        // beyond this cleanup: They take it over
+        if (!std::get<2>(buffer_tuple)->detach())
+          delete std::get<2>(buffer_tuple);
       }
 #ifdef CPPUDDLE_HAVE_COUNTERS
       // Print performance counters
@@ -445,6 +745,9 @@ private:
                 << "--> Number wrong deallocation hints:                       "
                    "       "
                 << number_wrong_hints << std::endl
+                << "--> Number of contended location locks:                    "
+                   "       "
+                << number_contended_locks << std::endl
                 << "--> Number of buffers that were marked as used upon "
                    "cleanup:      "
                 << buffer_map.size() << std::endl
@@ -454,19 +757,24 @@ private:
                        100.0f
                 << "%" << std::endl;
 #endif
-      unused_buffer_list.clear();
+      unused_buffers.splice(unused_buffers.end(), unused_buffer_list);
       buffer_map.clear();
+      spare_map_nodes.clear();
+      spare_list_nodes.clear();
 #ifdef CPPUDDLE_HAVE_COUNTERS
       number_allocation = 0;
       number_recycling = 0;
       number_bad_alloc = 0;
       number_creation = 0;
       number_wrong_hints = 0;
+      number_contended_locks = 0;
 #endif
+      return unused_buffers;
     }
   public:
     ~buffer_manager() {
-      clean_all_buffers();
+      auto unused_buffers = clean_all_buffers();
+      release_unused_buffers(unused_buffers);
     }
 
   public: // Putting deleted constructors in public gives more useful error
@@ -487,6 +795,19 @@ public:
   buffer_recycler& operator=(buffer_recycler &&other) = delete;
 };
 
+#ifdef CPPUDDLE_HAVE_HPX
+/// Calls release in a continuation of fut (never blocks). The returned future
+/// gets ready after the release and carries the exception of fut, if any
+template <typename Future, typename Release>
+hpx::future<void> release_when_ready(Future fut, Release &&release) {
+  return std::move(fut).then(
+      [release = std::forward<Release>(release)](auto &&predecessor) mutable {
+        release();
+        predecessor.get(); // propagates exceptions of the work
+      });
+}
+#endif
+
 template <typename T, typename Host_Allocator> struct recycle_allocator {
   using value_type = T;
   const std::optional<size_t> dealloc_hint;
@@ -503,6 +824,12 @@ template <typename T, typename Host_Allocator> struct recycle_allocator {
     T *data = buffer_recycler::get<T, Host_Allocator>(n);
     return data;
   }
+  /// allocate, also returning the view reference counter of the buffer
+  T *allocate_counted(std::size_t n,
+                      detail::view_reference_counter *&reference_counter) {
+    return buffer_recycler::get<T, Host_Allocator>(n, false, std::nullopt,
+                                                   &reference_counter);
+  }
   void deallocate(T *p, std::size_t n) {
     buffer_recycler::mark_unused<T, Host_Allocator>(p, n);
   }
@@ -519,10 +846,44 @@ template <typename T, typename Host_Allocator> struct recycle_allocator {
         n, false, hpx::get_worker_thread_num());
     return data;
   }
+  /// allocate, also returning the view reference counter of the buffer
+  T *allocate_counted(std::size_t n,
+                      detail::view_reference_counter *&reference_counter) {
+    return buffer_recycler::get<T, Host_Allocator>(
+        n, false, hpx::get_worker_thread_num(), &reference_counter);
+  }
   void deallocate(T *p, std::size_t n) {
     buffer_recycler::mark_unused<T, Host_Allocator>(p, n, dealloc_hint);
   }
 #endif
+#ifdef CPPUDDLE_HAVE_HPX
+  /// deallocate once fut (the work still using p) is ready -- does not block
+  template <typename Future>
+  hpx::future<void> deallocate_after(T *p, std::size_t n, Future fut) {
+    return release_when_ready(std::move(fut), [p, n, hint = dealloc_hint]() {
+      buffer_recycler::mark_unused<T, Host_Allocator>(p, n, hint);
+    });
+  }
+  /// allocate for work on the stream of executor: prefers buffers last
+  /// released on it (see deallocate_on_stream). The stream is identified by
+  /// its handle (executor.get_stream()), see stream_handle
+  template <typename Executor>
+  T *allocate_on_stream(std::size_t n, const Executor &executor) {
+    return buffer_recycler::get<T, Host_Allocator>(
+        n, false, allocation_location(), nullptr,
+        stream_handle(executor));
+  }
+  /// deallocate while work on the stream of executor may still use p --
+  /// does not block: More work on the same stream can reuse p right away,
+  /// other requests only get it once completion is ready
+  template <typename Executor>
+  void deallocate_on_stream(T *p, std::size_t n, const Executor &executor,
+                            hpx::shared_future<void> completion) {
+    buffer_recycler::mark_unused<T, Host_Allocator>(
+        p, n, dealloc_hint,
+        stream_affinity{stream_handle(executor), std::move(completion)});
+  }
+#endif
 
   template <typename... Args>
   inline void construct(T *p, Args... args) noexcept {
@@ -568,6 +929,12 @@ struct aggressive_recycle_allocator {
         n, true); // also initializes the buffer if it isn't reused
     return data;
   }
+  /// allocate, also returning the view reference counter of the buffer
+  T *allocate_counted(std::size_t n,
+                      detail::view_reference_counter *&reference_counter) {
+    return buffer_recycler::get<T, Host_Allocator>(n, true, std::nullopt,
+                                                   &reference_counter);
+  }
   void deallocate(T *p, std::size_t n) {
     buffer_recycler::mark_unused<T, Host_Allocator>(p, n);
   }
@@ -585,10 +952,44 @@ struct aggressive_recycle_allocator {
                                                 // if it isn't reused
     return data;
   }
+  /// allocate, also returning the view reference counter of the buffer
+  T *allocate_counted(std::size_t n,
+                      detail::view_reference_counter *&reference_counter) {
+    return buffer_recycler::get<T, Host_Allocator>(
+        n, true, hpx::get_worker_thread_num(), &reference_counter);
+  }
   void deallocate(T *p, std::size_t n) {
     buffer_recycler::mark_unused<T, Host_Allocator>(p, n, dealloc_hint);
   }
 #endif
+#ifdef CPPUDDLE_HAVE_HPX
+  /// deallocate once fut (the work still using p) is ready -- does not block
+  template <typename Future>
+  hpx::future<void> deallocate_after(T *p, std::size_t n, Future fut) {
+    return release_when_ready(std::move(fut), [p, n, hint = dealloc_hint]() {
+      buffer_recycler::mark_unused<T, Host_Allocator>(p, n, hint);
+    });
+  }
+  /// allocate for work on the stream of executor: prefers buffers last
+  /// released on it (see deallocate_on_stream). The stream is identified by
+  /// its handle (executor.get_stream()), see stream_handle
+  template <typename Executor>
+  T *allocate_on_stream(std::size_t n, const Executor &executor) {
+    return buffer_recycler::get<T, Host_Allocator>(
+        n, true, allocation_location(), nullptr,
+        stream_handle(executor));
+  }
+  /// deallocate while work on the stream of executor may still use p --
+  /// does not block: More work on the same stream can reuse p right away,
+  /// other requests only get it once completion is ready
+  template <typename Executor>
+  void deallocate_on_stream(T *p, std::size_t n, const Executor &executor,
+                            hpx::shared_future<void> completion) {
+    buffer_recycler::mark_unused<T, Host_Allocator>(
+        p, n, dealloc_hint,
+        stream_affinity{stream_handle(executor), std::move(completion)});
+  }
+#endif
 
 #ifndef CPPUDDLE_DEACTIVATE_AGGRESSIVE_ALLOCATORS
   template <typename... Args>
@@ -639,6 +1040,28 @@ template <typename T, std::enable_if_t<std::is_trivial<T>::value, int> = 0>
 using aggressive_recycle_std =
     detail::aggressive_recycle_allocator<T, std::allocator<T>>;
 
+#ifdef CPPUDDLE_HAVE_HPX
+/// Gives a buffer back to the recycler once fut (the asynchronous work still
+/// using the buffer) is ready -- without blocking the caller
+/** Takes ownership of the buffer (any movable buffer, such as std::vectors or
+ * Kokkos views with recycle allocators). The returned future gets ready after
+ * the release (wait for it before cleaning up the recycler) and carries the
+ * exception of fut, if any.
+ */
+template <typename Buffer, typename Future>
+hpx::future<void> release_after(Buffer &&buffer, Future fut) {
+  static_assert(!std::is_lvalue_reference_v<Buffer>,
+                "release_after takes ownership of the buffer: Pass it as "
+                "rvalue (std::move)");
+  return detail::release_when_ready(
+      std::move(fut),
+      [buffer = std::decay_t<Buffer>(std::forward<Buffer>(buffer))]() mutable {
+        // Release now (not whenever the continuation gets destroyed)
+        std::decay_t<Buffer> released_buffer(std::move(buffer));
+      });
+}
+#endif
+
 /// Deletes all buffers (even ones still marked as used), delete the buffer
 /// managers and the recycler itself
 inline void force_cleanup() { detail::buffer_recycler::clean_all(); }
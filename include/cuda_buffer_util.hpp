@@ -11,6 +11,7 @@
 #include <cuda_runtime.h>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace recycler {
 
@@ -61,6 +62,12 @@ template <class T> struct cuda_device_allocator {
   cuda_device_allocator() noexcept = default;
   template <class U>
   explicit cuda_device_allocator(cuda_device_allocator<U> const &) noexcept {}
+  /// Device the allocations go to (the current one)
+  static size_t get_device_id(void) {
+    int device = 0;
+    cudaGetDevice(&device);
+    return static_cast<size_t>(device);
+  }
   T *allocate(std::size_t n) {
     T *data;
     cudaError_t error = cudaMalloc(&data, n * sizeof(T));
@@ -137,8 +144,9 @@ struct cuda_device_buffer {
     // Allows for testing without any changes to other projects 
     assert(gpu_id == 0); 
 #endif
-    recycle_allocator_cuda_device<T>{}.deallocate(device_side_buffer,
-                                                  number_of_elements);
+    if (device_side_buffer != nullptr) // nullptr after release_after
+      recycle_allocator_cuda_device<T>{}.deallocate(device_side_buffer,
+                                                    number_of_elements);
   }
   // not yet implemented
   cuda_device_buffer(cuda_device_buffer const &other) = delete;
@@ -150,6 +158,19 @@ private:
   bool set_id{false};
 };
 
+#ifdef CPPUDDLE_HAVE_HPX
+/// Device buffers are not movable: Gives the device memory back to the
+/// recycler once fut is ready (see release_after in buffer_manager.hpp) --
+/// buffer does not own any memory afterwards
+template <typename T, typename Future>
+hpx::future<void> release_after(cuda_device_buffer<T> &buffer, Future fut) {
+  assert(buffer.device_side_buffer != nullptr);
+  T *device_side_buffer = std::exchange(buffer.device_side_buffer, nullptr);
+  return recycle_allocator_cuda_device<T>{}.deallocate_after(
+      device_side_buffer, buffer.number_of_elements, std::move(fut));
+}
+#endif
+
 template <typename T, typename Host_Allocator, std::enable_if_t<std::is_trivial<T>::value, int> = 0>
 struct cuda_aggregated_device_buffer {
   size_t gpu_id{0};
@@ -11,6 +11,7 @@
 #include <hip/hip_runtime.h>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace recycler {
 
@@ -67,6 +68,12 @@ template <class T> struct hip_device_allocator {
   hip_device_allocator() noexcept = default;
   template <class U>
   explicit hip_device_allocator(hip_device_allocator<U> const &) noexcept {}
+  /// Device the allocations go to (the current one)
+  static size_t get_device_id(void) {
+    int device = 0;
+    hipGetDevice(&device);
+    return static_cast<size_t>(device);
+  }
   T *allocate(std::size_t n) {
     T *data;
     hipError_t error = hipMalloc(&data, n * sizeof(T));
@@ -133,8 +140,9 @@ struct hip_device_buffer {
     // TODO Fix Multi GPU support
     // if (set_id)
     //   hipSetDevice(gpu_id);
-    recycle_allocator_hip_device<T>{}.deallocate(device_side_buffer,
-                                                  number_of_elements);
+    if (device_side_buffer != nullptr) // nullptr after release_after
+      recycle_allocator_hip_device<T>{}.deallocate(device_side_buffer,
+                                                   number_of_elements);
   }
   // not yet implemented
   hip_device_buffer(hip_device_buffer const &other) = delete;
@@ -146,6 +154,19 @@ private:
   bool set_id{false};
 };
 
+#ifdef CPPUDDLE_HAVE_HPX
+/// Device buffers are not movable: Gives the device memory back to the
+/// recycler once fut is ready (see release_after in buffer_manager.hpp) --
+/// buffer does not own any memory afterwards
+template <typename T, typename Future>
+hpx::future<void> release_after(hip_device_buffer<T> &buffer, Future fut) {
+  assert(buffer.device_side_buffer != nullptr);
+  T *device_side_buffer = std::exchange(buffer.device_side_buffer, nullptr);
+  return recycle_allocator_hip_device<T>{}.deallocate_after(
+      device_side_buffer, buffer.number_of_elements, std::move(fut));
+}
+#endif
+
 template <typename T, typename Host_Allocator, std::enable_if_t<std::is_trivial<T>::value, int> = 0>
 struct hip_aggregated_device_buffer {
   size_t gpu_id{0};
@@ -0,0 +1,161 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef KOKKOS_AGGREGATION_UTIL_HPP
+#define KOKKOS_AGGREGATION_UTIL_HPP
+
+#include <Kokkos_Core.hpp>
+#include <array>
+#include <cassert>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "aggregation_manager.hpp"
+#include "kokkos_buffer_util.hpp"
+
+namespace recycler {
+
+namespace detail {
+template <size_t index, size_t aggregation_dimension>
+auto slice_subview_argument(const std::pair<size_t, size_t> &slice_range) {
+  if constexpr (index == aggregation_dimension) {
+    return slice_range;
+  } else {
+    return Kokkos::ALL;
+  }
+}
+template <size_t aggregation_dimension, typename View, size_t... indices>
+auto slice_subview(const View &aggregated_view,
+                   const std::pair<size_t, size_t> &slice_range,
+                   std::index_sequence<indices...>) {
+  return Kokkos::subview(
+      aggregated_view,
+      slice_subview_argument<indices, aggregation_dimension>(slice_range)...);
+}
+
+/// Functor of an aggregated parallel_for: Gets the slice index plus the
+/// indices within the subview of the slice from the MDRange and calls f with
+/// the slice index and the indices within the aggregated view
+template <typename F, size_t aggregation_dimension>
+struct aggregated_slice_functor {
+  F f;
+  size_t slice_extent;
+
+  template <typename Index, typename... Indices>
+  KOKKOS_INLINE_FUNCTION void operator()(const Index slice,
+                                         const Indices... indices) const {
+    call(std::make_index_sequence<sizeof...(Indices)>{}, slice, indices...);
+  }
+
+private:
+  template <size_t... dims, typename Index, typename... Indices>
+  KOKKOS_INLINE_FUNCTION void call(std::index_sequence<dims...>,
+                                   const Index slice,
+                                   const Indices... indices) const {
+    f(slice, (dims == aggregation_dimension
+                  ? indices + slice * static_cast<Indices>(slice_extent)
+                  : indices)...);
+  }
+};
+} // end namespace detail
+
+/// Launched instead of the function of an aggregated parallel_for: One
+/// Kokkos::parallel_for over the MDRange (slices x extents of the slice
+/// subviews) on the execution space instance of the underlying executor
+/** Does not fence: The returned future of the underlying executor becomes
+ * ready once the parallel_for (and everything enqueued before) is done.
+ */
+template <size_t aggregation_dimension>
+struct aggregated_parallel_for_launcher {
+  template <typename Executor, typename F, size_t rank>
+  hpx::lcos::future<void>
+  operator()(Executor *executor, const std::string &label, const F &f,
+             const size_t number_slices,
+             const std::array<size_t, rank> &slice_extents) const {
+    static_assert(rank + 1 <= 6, "MDRangePolicy supports up to rank 6");
+    using execution_space_t = std::decay_t<decltype(executor->instance())>;
+    using policy_t =
+        Kokkos::MDRangePolicy<execution_space_t, Kokkos::Rank<rank + 1>>;
+    typename policy_t::point_type lower{};
+    typename policy_t::point_type upper{};
+    upper[0] = number_slices;
+    for (size_t dim = 0; dim < rank; dim++) {
+      lower[dim + 1] = 0;
+      upper[dim + 1] = slice_extents[dim];
+    }
+    Kokkos::parallel_for(
+        label, policy_t(executor->instance(), lower, upper),
+        detail::aggregated_slice_functor<F, aggregation_dimension>{
+            f, slice_extents[aggregation_dimension]});
+    return executor->get_future();
+  }
+  /// Stateless -- required for the debug checks of the call arguments
+  friend constexpr bool
+  operator==(const aggregated_parallel_for_launcher &,
+             const aggregated_parallel_for_launcher &) noexcept {
+    return true;
+  }
+  friend constexpr bool
+  operator!=(const aggregated_parallel_for_launcher &,
+             const aggregated_parallel_for_launcher &) noexcept {
+    return false;
+  }
+};
+
+/// Subview of the part of an aggregated view that belongs to slice
+/** The aggregated view consists of slice.number_slices equally sized parts
+ * along aggregation_dimension (one per slice, in the order of the slice
+ * IDs). Multi-slices get the parts of all of their slices.
+ */
+template <size_t aggregation_dimension = 0, typename View, typename Slice>
+auto get_slice_subview(const View &aggregated_view, const Slice &slice) {
+  constexpr size_t rank = static_cast<size_t>(View::rank);
+  static_assert(aggregation_dimension < rank,
+                "Aggregation dimension exceeds the rank of the view");
+  const size_t aggregated_extent =
+      aggregated_view.extent(aggregation_dimension);
+  assert(aggregated_extent % slice.number_slices == 0);
+  const size_t slice_extent = aggregated_extent / slice.number_slices;
+  const std::pair<size_t, size_t> slice_range{
+      slice.id * slice_extent,
+      (slice.id + slice.number_local_slices) * slice_extent};
+  return detail::slice_subview<aggregation_dimension>(
+      aggregated_view, slice_range, std::make_index_sequence<rank>{});
+}
+
+/// Aggregated parallel_for over the subviews of all slices
+/** f(slice, indices...) gets called for all slices and all indices of their
+ * subviews (see get_slice_subview) within one MDRange -- indices are the
+ * ones within the aggregated view. Like with async, all slices need to make
+ * the same call, which is launched only once for all of them. The
+ * parallel_for runs on the instance() of the underlying executor, the
+ * returned future is the one of the underlying executor (get_future) after
+ * the launch.
+ */
+template <size_t aggregation_dimension = 0, typename Slice, typename View,
+          typename F>
+hpx::lcos::shared_future<void>
+aggregated_parallel_for(Slice &slice, const std::string &label,
+                        const View &aggregated_view, const F &f) {
+  constexpr size_t rank = static_cast<size_t>(View::rank);
+  static_assert(aggregation_dimension < rank,
+                "Aggregation dimension exceeds the rank of the view");
+  std::array<size_t, rank> slice_extents{};
+  for (size_t dim = 0; dim < rank; dim++)
+    slice_extents[dim] = aggregated_view.extent(dim);
+  assert(slice_extents[aggregation_dimension] % slice.number_slices == 0);
+  slice_extents[aggregation_dimension] /= slice.number_slices;
+  // Copy the arguments -- the aggregated launch may happen after this call
+  // returned
+  return slice.wrap_async(
+      aggregated_parallel_for_launcher<aggregation_dimension>{},
+      &slice.get_underlying_executor(), std::string(label), F(f), size_t{slice.number_slices},
+      std::move(slice_extents));
+}
+
+} // end namespace recycler
+
+#endif
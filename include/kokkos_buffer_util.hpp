@@ -7,74 +7,149 @@
 #define KOKKOS_BUFFER_UTIL_HPP
 #include <Kokkos_Core.hpp>
 #include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "buffer_manager.hpp"
 
 namespace recycler {
 
-template<typename element_type, typename alloc_type>
-struct view_deleter {
-  alloc_type allocator;
+namespace detail {
+/// Does the allocator hand out the view reference counter of its buffers?
+template <typename alloc_type, typename element_type, typename = void>
+struct has_allocate_counted : std::false_type {};
+template <typename alloc_type, typename element_type>
+struct has_allocate_counted<
+    alloc_type, element_type,
+    std::void_t<decltype(std::declval<alloc_type &>().allocate_counted(
+        std::size_t{}, std::declval<view_reference_counter *&>()))>>
+    : std::true_type {};
+
+template <typename element_type> struct counted_view_buffer {
+  element_type *data;
   size_t total_elements;
-  view_deleter(alloc_type &alloc, size_t total_elements) : allocator(alloc),
-    total_elements(total_elements) {}
-  void operator()(element_type* p) {
-    allocator.deallocate(p, total_elements);
-  }
+  view_reference_counter *references;
 };
 
+/// Allocates the buffer of a new view -- the reference counter comes from the
+/// buffer metadata if possible (no heap allocation per view)
+template <typename element_type, typename alloc_type>
+counted_view_buffer<element_type> allocate_view_buffer(alloc_type &allocator,
+                                                       const size_t total_elements) {
+  counted_view_buffer<element_type> buffer{nullptr, total_elements, nullptr};
+  if constexpr (has_allocate_counted<alloc_type, element_type>::value) {
+    buffer.data = allocator.allocate_counted(total_elements, buffer.references);
+  } else {
+    buffer.data = allocator.allocate(total_elements);
+  }
+  // Fallback for allocators without buffer metadata (detached: the last view
+  // deletes it)
+  if (buffer.references == nullptr)
+    buffer.references = new view_reference_counter{true};
+  buffer.references->add_allocation();
+  return buffer;
+}
+
+/// Drops one view handle -- the last one gives all allocations back
+template <typename element_type, typename alloc_type>
+void release_view_buffer(alloc_type &allocator, element_type *data,
+                         const size_t total_elements,
+                         view_reference_counter *references) {
+  if (references == nullptr) // moved-from view
+    return;
+  bool delete_references = false;
+  const size_t allocations = references->release_handle(delete_references);
+  for (size_t i = 0; i < allocations; i++)
+    allocator.deallocate(data, total_elements);
+  if (delete_references)
+    delete references;
+}
+} // end namespace detail
+
+/// Recycled view of an aggregated buffer (alloc_type being an Allocator_Slice)
+/** The views of all slices share one reference counter: the one of the
+ * buffer ticket (see Aggregated_Executor). Each view still accounts for the
+ * allocation of its own slice, but whichever view of any slice drops the last
+ * handle gives back the allocations of all slices (through its own slice
+ * allocator) -- the aggregated buffer thus stays in use until the views of
+ * all slices are gone.
+ */
 template <typename kokkos_type, typename alloc_type, typename element_type>
 class aggregated_recycled_view : public kokkos_type {
 private:
-  alloc_type allocator;
+  /// Slice allocators are not assignable (but copyable)
+  std::optional<alloc_type> allocator;
   size_t total_elements{0};
-  std::shared_ptr<element_type> data_ref_counter;
+  detail::view_reference_counter *references{nullptr};
+
+  template <class... Args>
+  aggregated_recycled_view(alloc_type &alloc,
+                           detail::counted_view_buffer<element_type> buffer,
+                           Args... args)
+      : kokkos_type(buffer.data, args...), allocator(alloc),
+        total_elements(buffer.total_elements), references(buffer.references) {}
+
+  void release(void) {
+    detail::release_view_buffer(*allocator, this->data(), total_elements,
+                                references);
+    references = nullptr;
+  }
 
 public:
   using view_type = kokkos_type;
   template <class... Args>
   explicit aggregated_recycled_view(alloc_type &alloc, Args... args)
-      : kokkos_type(
-            alloc.allocate(kokkos_type::required_allocation_size(args...) /
+      : aggregated_recycled_view(
+            alloc,
+            detail::allocate_view_buffer<element_type>(
+                alloc, kokkos_type::required_allocation_size(args...) /
                            sizeof(element_type)),
-            args...),
-        total_elements(kokkos_type::required_allocation_size(args...) /
-                       sizeof(element_type)),
-        allocator(alloc),
-        data_ref_counter(this->data(), view_deleter<element_type, alloc_type>(
-                                           alloc, total_elements)) {}
+            args...) {}
 
   aggregated_recycled_view(
       const aggregated_recycled_view<kokkos_type, alloc_type, element_type> &other)
-      : kokkos_type(other), allocator(other.allocator) {
-    data_ref_counter = other.data_ref_counter;
-    total_elements = other.total_elements;
+      : kokkos_type(other), allocator(other.allocator),
+        total_elements(other.total_elements), references(other.references) {
+    if (references)
+      references->add_handle();
   }
 
   aggregated_recycled_view<kokkos_type, alloc_type, element_type> &
   operator=(const aggregated_recycled_view<kokkos_type, alloc_type, element_type> &other) {
-    data_ref_counter = other.data_ref_counter;
-    allocator = other.allocator;
-    kokkos_type::operator=(other);
-    total_elements = other.total_elements;
+    if (this != &other) {
+      if (other.references)
+        other.references->add_handle();
+      release();
+      allocator.emplace(*other.allocator);
+      kokkos_type::operator=(other);
+      total_elements = other.total_elements;
+      references = other.references;
+    }
     return *this;
   }
 
   aggregated_recycled_view(
       aggregated_recycled_view<kokkos_type, alloc_type, element_type> &&other) noexcept
-      : kokkos_type(other), allocator(other.allocator) {
-    data_ref_counter = other.data_ref_counter;
-    total_elements = other.total_elements;
+      : kokkos_type(other), allocator(other.allocator),
+        total_elements(other.total_elements), references(other.references) {
+    other.references = nullptr;
   }
 
   aggregated_recycled_view<kokkos_type, alloc_type, element_type> &operator=(
       aggregated_recycled_view<kokkos_type, alloc_type, element_type> &&other) noexcept {
-    data_ref_counter = other.data_ref_counter;
-    allocator = other.allocator;
-    kokkos_type::operator=(other);
-    total_elements = other.total_elements;
+    if (this != &other) {
+      release();
+      allocator.emplace(*other.allocator);
+      kokkos_type::operator=(other);
+      total_elements = other.total_elements;
+      references = other.references;
+      other.references = nullptr;
+    }
     return *this;
   }
 
-  ~aggregated_recycled_view() {}
+  ~aggregated_recycled_view() { release(); }
 };
 
 template <typename kokkos_type, typename alloc_type, typename element_type>
@@ -82,54 +157,71 @@ class recycled_view : public kokkos_type {
 private:
   static alloc_type allocator;
   size_t total_elements{0};
-  std::shared_ptr<element_type> data_ref_counter;
+  detail::view_reference_counter *references{nullptr};
+
+  template <class... Args>
+  recycled_view(detail::counted_view_buffer<element_type> buffer,
+                Args... args)
+      : kokkos_type(buffer.data, args...),
+        total_elements(buffer.total_elements), references(buffer.references) {}
+
+  void release(void) {
+    detail::release_view_buffer(allocator, this->data(), total_elements,
+                                references);
+    references = nullptr;
+  }
 
 public:
   using view_type = kokkos_type;
   template <class... Args>
   explicit recycled_view(Args... args)
-      : kokkos_type(
-            allocator.allocate(kokkos_type::required_allocation_size(args...) /
-                               sizeof(element_type)),
-            args...),
-        total_elements(kokkos_type::required_allocation_size(args...) /
-                       sizeof(element_type)),
-        data_ref_counter(this->data(), view_deleter<element_type, alloc_type>(
-                                           allocator, total_elements)) {}
+      : recycled_view(detail::allocate_view_buffer<element_type>(
+                          allocator,
+                          kokkos_type::required_allocation_size(args...) /
+                              sizeof(element_type)),
+                      args...) {}
 
   recycled_view(
       const recycled_view<kokkos_type, alloc_type, element_type> &other)
-      : kokkos_type(other) {
-    total_elements = other.total_elements;
-    data_ref_counter = other.data_ref_counter;
-
+      : kokkos_type(other), total_elements(other.total_elements),
+        references(other.references) {
+    if (references)
+      references->add_handle();
   }
 
   recycled_view<kokkos_type, alloc_type, element_type> &
   operator=(const recycled_view<kokkos_type, alloc_type, element_type> &other) {
-    data_ref_counter = other.data_ref_counter;
-    kokkos_type::operator=(other);
-    total_elements = other.total_elements;
-    allocator.increase_usage_counter(other.data(), other.total_elements);
+    if (this != &other) {
+      if (other.references)
+        other.references->add_handle();
+      release();
+      kokkos_type::operator=(other);
+      total_elements = other.total_elements;
+      references = other.references;
+    }
     return *this;
   }
 
   recycled_view(
       recycled_view<kokkos_type, alloc_type, element_type> &&other) noexcept
-      : kokkos_type(other) {
-    data_ref_counter = other.data_ref_counter;
-    total_elements = other.total_elements;
+      : kokkos_type(other), total_elements(other.total_elements),
+        references(other.references) {
+    other.references = nullptr;
   }
 
   recycled_view<kokkos_type, alloc_type, element_type> &operator=(
       recycled_view<kokkos_type, alloc_type, element_type> &&other) noexcept {
-    data_ref_counter = other.data_ref_counter;
-    kokkos_type::operator=(other);
-    total_elements = other.total_elements;
+    if (this != &other) {
+      release();
+      kokkos_type::operator=(other);
+      total_elements = other.total_elements;
+      references = other.references;
+      other.references = nullptr;
+    }
     return *this;
   }
 
-  ~recycled_view() {  }
+  ~recycled_view() { release(); }
 };
 
 template <class kokkos_type, class alloc_type, class element_type>
@@ -0,0 +1,115 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef KOKKOS_PARTITION_UTIL_HPP
+#define KOKKOS_PARTITION_UTIL_HPP
+
+#include <hpx/execution.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace recycler {
+
+/// Disjoint partitions (Kokkos::Experimental::partition_space) of a host
+/// execution space -- one for each executor of a stream pool
+/** Each partition gets an equal share of the threads of the execution space
+ * (on backends supporting partitioning, such as OpenMP). Other backends (such
+ * as HPX) return independent instances which still share all cores.
+ */
+template <typename ExecutionSpace = Kokkos::DefaultHostExecutionSpace>
+class host_space_partitions {
+private:
+  static_assert(
+      Kokkos::SpaceAccessibility<ExecutionSpace, Kokkos::HostSpace>::accessible,
+      "Partitioned execution spaces are only available for host spaces");
+  std::vector<ExecutionSpace> partitions{};
+  size_t next_partition_index{0};
+
+public:
+  explicit host_space_partitions(const size_t number_partitions,
+                                 const ExecutionSpace &space = ExecutionSpace{}) {
+    if (number_partitions == 0)
+      throw std::runtime_error(
+          "host_space_partitions: Requires at least one partition");
+    if (number_partitions > static_cast<size_t>(space.concurrency()))
+      throw std::runtime_error("host_space_partitions: More partitions than "
+                               "threads in the execution space");
+    partitions.reserve(number_partitions);
+    // Split off one partition at a time (works with the variadic
+    // partition_space of all Kokkos versions)
+    ExecutionSpace remaining_space = space;
+    for (size_t remaining = number_partitions; remaining > 1; remaining--) {
+      auto split = Kokkos::Experimental::partition_space(
+          remaining_space, 1.0, static_cast<double>(remaining - 1));
+      partitions.push_back(split[0]);
+      remaining_space = split[1];
+    }
+    partitions.push_back(remaining_space);
+    assert(partitions.size() == number_partitions);
+  }
+
+  /// Hands out the partitions round robin (once per executor of a pool)
+  const ExecutionSpace &next_partition(void) {
+    const ExecutionSpace &partition = partitions[next_partition_index];
+    next_partition_index = (next_partition_index + 1) % partitions.size();
+    return partition;
+  }
+  const ExecutionSpace &operator[](const size_t index) const {
+    assert(index < partitions.size());
+    return partitions[index];
+  }
+  size_t size(void) const { return partitions.size(); }
+};
+
+/// Stream pool interface: Executor running on its own partition of a host
+/// execution space
+/** Usable with all stream pools (round_robin_pool, priority_pool, ...), the
+ * pool just forwards the partitions to the constructor of each executor:
+ *
+ * using executor_t = recycler::partitioned_executor<hpx::kokkos::openmp_executor>;
+ * stream_pool::init<executor_t, round_robin_pool<executor_t>>(
+ *     4, recycler::host_space_partitions<Kokkos::OpenMP>(4));
+ *
+ * Executor needs to be constructible from an instance of its execution space
+ * (like the HPX-Kokkos executors).
+ */
+template <typename Executor> class partitioned_executor : public Executor {
+public:
+  using execution_space = typename Executor::execution_space;
+  explicit partitioned_executor(
+      host_space_partitions<execution_space> &partitions)
+      : Executor(partitions.next_partition()) {}
+  explicit partitioned_executor(
+      host_space_partitions<execution_space> &&partitions)
+      : partitioned_executor(partitions) {}
+};
+
+} // end namespace recycler
+
+namespace hpx { namespace parallel { namespace execution {
+    // Partitioned executors are whatever their underlying executor is
+    template <typename Executor>
+    struct is_one_way_executor<recycler::partitioned_executor<Executor>>
+      : is_one_way_executor<Executor>
+    {};
+    template <typename Executor>
+    struct is_two_way_executor<recycler::partitioned_executor<Executor>>
+      : is_two_way_executor<Executor>
+    {};
+    template <typename Executor>
+    struct is_bulk_one_way_executor<recycler::partitioned_executor<Executor>>
+      : is_bulk_one_way_executor<Executor>
+    {};
+    template <typename Executor>
+    struct is_bulk_two_way_executor<recycler::partitioned_executor<Executor>>
+      : is_bulk_two_way_executor<Executor>
+    {};
+}}}
+
+#endif
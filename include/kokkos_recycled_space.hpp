@@ -0,0 +1,266 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef KOKKOS_RECYCLED_SPACE_HPP
+#define KOKKOS_RECYCLED_SPACE_HPP
+
+#include "buffer_manager.hpp"
+
+#include <Kokkos_Core.hpp>
+#include <string>
+#include <type_traits>
+
+// The allocation record and the access/deep copy traits below specialize
+// Kokkos::Impl internals that change between Kokkos releases (see the version
+// check in CMakeLists.txt)
+#if KOKKOS_VERSION < 30600 || KOKKOS_VERSION >= 40100
+#error "recycler::RecycledSpace requires 3.6 <= Kokkos version < 4.1"
+#endif
+
+namespace recycler {
+
+namespace detail {
+/// Host_Allocator for the buffer_recycler getting its memory from a Kokkos
+/// memory space
+template <class T, class MemorySpace> struct kokkos_space_allocator {
+  using value_type = T;
+  kokkos_space_allocator() noexcept = default;
+  template <class U>
+  explicit kokkos_space_allocator(
+      kokkos_space_allocator<U, MemorySpace> const &) noexcept {}
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(MemorySpace{}.allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t n) {
+    MemorySpace{}.deallocate(p, n * sizeof(T));
+  }
+};
+template <class T, class U, class MemorySpace>
+constexpr bool
+operator==(kokkos_space_allocator<T, MemorySpace> const &,
+           kokkos_space_allocator<U, MemorySpace> const &) noexcept {
+  return true;
+}
+template <class T, class U, class MemorySpace>
+constexpr bool
+operator!=(kokkos_space_allocator<T, MemorySpace> const &,
+           kokkos_space_allocator<U, MemorySpace> const &) noexcept {
+  return false;
+}
+} // end namespace detail
+
+/// Kokkos memory space whose allocations go through the buffer_recycler
+/** Wraps UnderlyingSpace (which provides the actual memory and the execution
+ * space). Managed views in this space recycle their buffers transparently:
+ * Kokkos::View<double **, recycler::RecycledHostSpace> a("a", n, m);
+ * Buffers are recycled by their size in bytes. They are only given back to
+ * UnderlyingSpace by the recycler cleanup (recycler::force_cleanup), which
+ * should thus happen before Kokkos::finalize. Like with the Kokkos memory
+ * spaces, deallocate does not fence: The allocation records of the managed
+ * views fence the execution space instance they were allocated with first.
+ */
+template <class UnderlyingSpace> class RecycledSpace {
+public:
+  using memory_space = RecycledSpace<UnderlyingSpace>;
+  using underlying_space = UnderlyingSpace;
+  using execution_space = typename UnderlyingSpace::execution_space;
+  using device_type = Kokkos::Device<execution_space, memory_space>;
+  using size_type = typename UnderlyingSpace::size_type;
+
+  void *allocate(const size_t arg_alloc_size) const {
+    return allocate("[unlabeled]", arg_alloc_size);
+  }
+  void *allocate(const char *arg_label, const size_t arg_alloc_size,
+                 const size_t arg_logical_size = 0) const {
+    return static_cast<void *>(recycle_allocator_t{}.allocate(arg_alloc_size));
+  }
+  void deallocate(void *const arg_alloc_ptr, const size_t arg_alloc_size) const {
+    deallocate("[unlabeled]", arg_alloc_ptr, arg_alloc_size);
+  }
+  void deallocate(const char *arg_label, void *const arg_alloc_ptr,
+                  const size_t arg_alloc_size,
+                  const size_t arg_logical_size = 0) const {
+    recycle_allocator_t{}.deallocate(static_cast<char *>(arg_alloc_ptr),
+                                     arg_alloc_size);
+  }
+
+  static constexpr const char *name(void) { return "RecycledSpace"; }
+
+private:
+  using recycle_allocator_t = detail::recycle_allocator<
+      char, detail::kokkos_space_allocator<char, UnderlyingSpace>>;
+};
+
+using RecycledHostSpace = RecycledSpace<Kokkos::HostSpace>;
+
+} // end namespace recycler
+
+namespace Kokkos {
+namespace Impl {
+
+// Accessibility and deep copies: Same as the underlying space
+
+template <class UnderlyingSpace, class OtherSpace>
+struct MemorySpaceAccess<recycler::RecycledSpace<UnderlyingSpace>, OtherSpace> {
+  enum : bool { assignable = false };
+  enum : bool {
+    accessible = MemorySpaceAccess<UnderlyingSpace, OtherSpace>::accessible
+  };
+  enum : bool {
+    deepcopy = MemorySpaceAccess<UnderlyingSpace, OtherSpace>::deepcopy
+  };
+};
+template <class OtherSpace, class UnderlyingSpace>
+struct MemorySpaceAccess<OtherSpace, recycler::RecycledSpace<UnderlyingSpace>> {
+  enum : bool { assignable = false };
+  enum : bool {
+    accessible = MemorySpaceAccess<OtherSpace, UnderlyingSpace>::accessible
+  };
+  enum : bool {
+    deepcopy = MemorySpaceAccess<OtherSpace, UnderlyingSpace>::deepcopy
+  };
+};
+template <class UnderlyingSpace>
+struct MemorySpaceAccess<recycler::RecycledSpace<UnderlyingSpace>,
+                         recycler::RecycledSpace<UnderlyingSpace>> {
+  enum : bool { assignable = true };
+  enum : bool { accessible = true };
+  enum : bool { deepcopy = true };
+};
+// Disambiguation with the AnonymousSpace specializations
+template <class UnderlyingSpace>
+struct MemorySpaceAccess<recycler::RecycledSpace<UnderlyingSpace>,
+                         Kokkos::AnonymousSpace>
+    : MemorySpaceAccess<UnderlyingSpace, Kokkos::AnonymousSpace> {};
+template <class UnderlyingSpace>
+struct MemorySpaceAccess<Kokkos::AnonymousSpace,
+                         recycler::RecycledSpace<UnderlyingSpace>>
+    : MemorySpaceAccess<Kokkos::AnonymousSpace, UnderlyingSpace> {};
+
+template <class UnderlyingSpace, class OtherSpace, class ExecutionSpace>
+struct DeepCopy<recycler::RecycledSpace<UnderlyingSpace>, OtherSpace,
+                ExecutionSpace>
+    : DeepCopy<UnderlyingSpace, OtherSpace, ExecutionSpace> {
+  using DeepCopy<UnderlyingSpace, OtherSpace, ExecutionSpace>::DeepCopy;
+};
+template <class OtherSpace, class UnderlyingSpace, class ExecutionSpace>
+struct DeepCopy<OtherSpace, recycler::RecycledSpace<UnderlyingSpace>,
+                ExecutionSpace>
+    : DeepCopy<OtherSpace, UnderlyingSpace, ExecutionSpace> {
+  using DeepCopy<OtherSpace, UnderlyingSpace, ExecutionSpace>::DeepCopy;
+};
+template <class UnderlyingSpace, class ExecutionSpace>
+struct DeepCopy<recycler::RecycledSpace<UnderlyingSpace>,
+                recycler::RecycledSpace<UnderlyingSpace>, ExecutionSpace>
+    : DeepCopy<UnderlyingSpace, UnderlyingSpace, ExecutionSpace> {
+  using DeepCopy<UnderlyingSpace, UnderlyingSpace, ExecutionSpace>::DeepCopy;
+};
+
+/// Allocation record of the managed views: Header and data share one
+/// recycled buffer
+template <class UnderlyingSpace>
+class SharedAllocationRecord<recycler::RecycledSpace<UnderlyingSpace>, void>
+    : public SharedAllocationRecord<void, void> {
+private:
+  using memory_space = recycler::RecycledSpace<UnderlyingSpace>;
+  using RecordBase = SharedAllocationRecord<void, void>;
+  static constexpr bool host_accessible_header =
+      MemorySpaceAccess<Kokkos::HostSpace, UnderlyingSpace>::accessible;
+
+  SharedAllocationRecord(const SharedAllocationRecord &) = delete;
+  SharedAllocationRecord &operator=(const SharedAllocationRecord &) = delete;
+
+  static void deallocate(RecordBase *arg_rec) {
+    delete static_cast<SharedAllocationRecord *>(arg_rec);
+  }
+
+#ifdef KOKKOS_ENABLE_DEBUG
+  static inline RecordBase s_root_record;
+#endif
+
+  const memory_space m_space;
+  const std::string m_record_label;
+  /// Instance the buffer was allocated with (the default instance unless the
+  /// view got allocated with Kokkos::view_alloc(instance, ...))
+  const typename memory_space::execution_space m_exec;
+
+  template <typename ExecutionSpace>
+  static typename memory_space::execution_space
+  owning_instance(const ExecutionSpace &exec_space) {
+    if constexpr (std::is_same_v<ExecutionSpace,
+                                 typename memory_space::execution_space>) {
+      return exec_space;
+    } else {
+      return typename memory_space::execution_space{};
+    }
+  }
+
+  void fill_header(const std::string &arg_label) {
+    if constexpr (host_accessible_header) {
+      Kokkos::Impl::fill_host_accessible_header_info(
+          this, *RecordBase::m_alloc_ptr, arg_label);
+    } else {
+      SharedAllocationHeader header;
+      Kokkos::Impl::fill_host_accessible_header_info(this, header, arg_label);
+      Kokkos::Impl::DeepCopy<UnderlyingSpace, Kokkos::HostSpace,
+                             typename memory_space::execution_space>(
+          m_exec, RecordBase::m_alloc_ptr, &header,
+          sizeof(SharedAllocationHeader));
+      m_exec.fence("recycler::RecycledSpace: fence after copying header");
+    }
+  }
+
+protected:
+  ~SharedAllocationRecord() {
+    // The next owner of the buffer must not race with kernels still using it
+    // (only the owning instance though)
+    m_exec.fence("recycler::RecycledSpace: fence before recycling a buffer");
+    m_space.deallocate(m_record_label.c_str(), RecordBase::m_alloc_ptr,
+                       RecordBase::m_alloc_size,
+                       RecordBase::m_alloc_size -
+                           sizeof(SharedAllocationHeader));
+  }
+
+  SharedAllocationRecord(
+      const memory_space &arg_space, const std::string &arg_label,
+      const size_t arg_alloc_size,
+      const RecordBase::function_type arg_dealloc = &deallocate)
+      : SharedAllocationRecord(typename memory_space::execution_space{},
+                               arg_space, arg_label, arg_alloc_size,
+                               arg_dealloc) {}
+  template <typename ExecutionSpace>
+  SharedAllocationRecord(
+      const ExecutionSpace &exec_space, const memory_space &arg_space,
+      const std::string &arg_label, const size_t arg_alloc_size,
+      const RecordBase::function_type arg_dealloc = &deallocate)
+      : RecordBase(
+#ifdef KOKKOS_ENABLE_DEBUG
+            &s_root_record,
+#endif
+            static_cast<SharedAllocationHeader *>(arg_space.allocate(
+                arg_label.c_str(),
+                sizeof(SharedAllocationHeader) + arg_alloc_size,
+                arg_alloc_size)),
+            sizeof(SharedAllocationHeader) + arg_alloc_size, arg_dealloc,
+            arg_label),
+        m_space(arg_space), m_record_label(arg_label),
+        m_exec(owning_instance(exec_space)) {
+    fill_header(arg_label);
+  }
+
+public:
+  std::string get_label() const { return m_record_label; }
+
+  static SharedAllocationRecord *allocate(const memory_space &arg_space,
+                                          const std::string &arg_label,
+                                          const size_t arg_alloc_size) {
+    return new SharedAllocationRecord(arg_space, arg_label, arg_alloc_size);
+  }
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif
@@ -0,0 +1,92 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef KOKKOS_SCRATCH_UTIL_HPP
+#define KOKKOS_SCRATCH_UTIL_HPP
+
+#include <Kokkos_Core.hpp>
+#include <cassert>
+#include <type_traits>
+
+#include "buffer_manager.hpp"
+#include "kokkos_buffer_util.hpp"
+
+namespace recycler {
+
+/// Temporary host view (for instance within the lambdas of a task) with a
+/// recycled buffer
+/** Buffers are recycled by their number of elements: All temporaries with the
+ * same value type and size (of any extents and layout) share the same
+ * buffers, repeated kernel invocations do not allocate.
+ */
+template <typename DataType, typename Layout = Kokkos::LayoutRight,
+          typename MemorySpace = Kokkos::HostSpace>
+using recycled_temporary_view = recycled_view<
+    Kokkos::View<DataType, Layout, MemorySpace, Kokkos::MemoryUnmanaged>,
+    recycle_std<typename Kokkos::View<DataType, Layout, MemorySpace>::value_type>,
+    typename Kokkos::View<DataType, Layout, MemorySpace>::value_type>;
+
+template <typename DataType, typename Layout = Kokkos::LayoutRight,
+          typename MemorySpace = Kokkos::HostSpace, typename... Extents>
+recycled_temporary_view<DataType, Layout, MemorySpace>
+make_temporary_view(const Extents... extents) {
+  static_assert(
+      Kokkos::SpaceAccessibility<Kokkos::HostSpace, MemorySpace>::accessible,
+      "Recycled temporary views use host memory");
+  return recycled_temporary_view<DataType, Layout, MemorySpace>(
+      static_cast<size_t>(extents)...);
+}
+
+/// Recycled scratch memory for team policies on host execution spaces
+/** Replaces the per-team scratch of Kokkos (set_scratch_size) for kernels
+ * that get launched repeatedly: One recycled buffer with elements_per_team
+ * elements for each team of the league. Within the kernel, each team gets
+ * its part with team_view(team_member).
+ */
+template <typename T,
+          typename ExecutionSpace = Kokkos::DefaultHostExecutionSpace>
+class recycled_team_scratch {
+private:
+  static_assert(
+      Kokkos::SpaceAccessibility<ExecutionSpace, Kokkos::HostSpace>::accessible,
+      "Recycled team scratch is only available for host execution spaces");
+  using scratch_view_t = recycled_temporary_view<T **>;
+  using team_view_t =
+      Kokkos::View<T *, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+  scratch_view_t scratch;
+
+public:
+  using execution_space = ExecutionSpace;
+  recycled_team_scratch(const size_t league_size,
+                        const size_t elements_per_team)
+      : scratch(league_size, elements_per_team) {}
+
+  /// Team policy with one team per part of the scratch buffer
+  Kokkos::TeamPolicy<ExecutionSpace>
+  team_policy(const ExecutionSpace &instance = ExecutionSpace{}) const {
+    return Kokkos::TeamPolicy<ExecutionSpace>(instance, league_size(),
+                                              Kokkos::AUTO);
+  }
+
+  template <typename TeamMember>
+  KOKKOS_INLINE_FUNCTION team_view_t
+  team_view(const TeamMember &team_member) const {
+    assert(static_cast<size_t>(team_member.league_rank()) < league_size());
+    return team_view_t(&scratch(team_member.league_rank(), 0),
+                       elements_per_team());
+  }
+
+  KOKKOS_INLINE_FUNCTION T *data(void) const { return scratch.data(); }
+  KOKKOS_INLINE_FUNCTION size_t league_size(void) const {
+    return scratch.extent(0);
+  }
+  KOKKOS_INLINE_FUNCTION size_t elements_per_team(void) const {
+    return scratch.extent(1);
+  }
+};
+
+} // end namespace recycler
+
+#endif
@@ -0,0 +1,112 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef LOCKED_HOST_BUFFER_UTIL_HPP
+#define LOCKED_HOST_BUFFER_UTIL_HPP
+
+#include "arena_buffer_util.hpp"
+#include "buffer_manager.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+namespace recycler {
+namespace detail {
+
+/// Page-locked (non-swappable) and pre-faulted host memory without any vendor
+/// runtime -- mmap(MAP_POPULATE) plus mlock
+/** Once the locked memory limit (RLIMIT_MEMLOCK) is exhausted, mappings stay
+ * unlocked (but still pre-faulted): This gets counted and reported once on
+ * stderr instead of failing the allocation.
+ */
+class locked_host_memory {
+public:
+  static void *map(const size_t bytes) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (data == MAP_FAILED)
+      throw std::bad_alloc{};
+    if (mlock(data, bytes) == 0) {
+      number_locked_mappings++;
+    } else {
+      number_unlocked_mappings++;
+      if (!warned_about_limit.exchange(true)) {
+        rlimit limit{};
+        getrlimit(RLIMIT_MEMLOCK, &limit);
+        std::cerr << "Warning: Could not lock " << bytes
+                  << " bytes of host memory (RLIMIT_MEMLOCK: "
+                  << static_cast<unsigned long long>(limit.rlim_cur)
+                  << " bytes)! Falling back to unlocked, pre-faulted memory..."
+                  << std::endl;
+      }
+    }
+    return data;
+  }
+  /// munmap unlocks the memory as well
+  static void unmap(void *p, const size_t bytes) { munmap(p, bytes); }
+
+  static size_t get_number_locked_mappings(void) {
+    return number_locked_mappings;
+  }
+  /// Mappings that exceeded RLIMIT_MEMLOCK
+  static size_t get_number_unlocked_mappings(void) {
+    return number_unlocked_mappings;
+  }
+
+private:
+  static inline std::atomic<size_t> number_locked_mappings{0};
+  static inline std::atomic<size_t> number_unlocked_mappings{0};
+  static inline std::atomic<bool> warned_about_limit{false};
+};
+
+template <class T> struct locked_host_allocator {
+  using value_type = T;
+  locked_host_allocator() noexcept = default;
+  template <class U>
+  explicit locked_host_allocator(locked_host_allocator<U> const &) noexcept {}
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(locked_host_memory::map(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t n) {
+    locked_host_memory::unmap(p, n * sizeof(T));
+  }
+};
+template <class T, class U>
+constexpr bool operator==(locked_host_allocator<T> const &,
+                          locked_host_allocator<U> const &) noexcept {
+  return true;
+}
+template <class T, class U>
+constexpr bool operator!=(locked_host_allocator<T> const &,
+                          locked_host_allocator<U> const &) noexcept {
+  return false;
+}
+
+/// Locked host memory gets mapped in chunks of 4 MiB, sub-allocations are
+/// cache line aligned (see buddy_arena)
+template <typename T>
+using locked_host_arena_allocator =
+    arena_allocator<T, locked_host_allocator<T>, size_t{1} << 22, 64>;
+
+} // end namespace detail
+
+/// Recycled page-locked host staging buffers (CPU-only counterpart of
+/// recycle_allocator_cuda_host)
+template <typename T, std::enable_if_t<std::is_trivial<T>::value, int> = 0>
+using recycle_allocator_locked_host =
+    detail::aggressive_recycle_allocator<T,
+                                         detail::locked_host_arena_allocator<T>>;
+
+} // end namespace recycler
+
+#endif
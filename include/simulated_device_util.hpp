@@ -0,0 +1,384 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SIMULATED_DEVICE_UTIL_HPP
+#define SIMULATED_DEVICE_UTIL_HPP
+
+#include "buffer_manager.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef CPPUDDLE_HAVE_HPX
+#include <hpx/execution.hpp>
+#include <hpx/futures/future.hpp>
+#endif
+
+namespace recycler {
+
+/// Behaviour of the simulated device (see simulated_device)
+struct simulated_device_config {
+  /// Time each allocation blocks the calling thread and all other allocations
+  /// (like cudaMalloc)
+  std::chrono::microseconds malloc_latency{100};
+  /// Time each deallocation blocks after waiting for all kernels in flight
+  /// (like cudaFree, which synchronizes the device)
+  std::chrono::microseconds free_latency{100};
+  /// Minimal runtime of each kernel launched on a simulated stream
+  std::chrono::microseconds kernel_latency{20};
+  /// Number of kernels that run concurrently (over all streams)
+  size_t max_concurrent_kernels{4};
+};
+
+namespace detail {
+
+/// Simulated accelerator on the host: Exercises the device code paths
+/// (recyclers, stream pools, aggregation) on machines without GPUs
+/** Device memory is host memory, but allocating and freeing it behaves like
+ * cudaMalloc/cudaFree: both are serialized device-wide and block for the
+ * configured latencies, freeing waits for all kernels in flight first.
+ * Kernels run on dedicated device threads (max_concurrent_kernels of them),
+ * in order per stream and for at least kernel_latency each. Kernels must not
+ * free device memory themselves (just like in CUDA). recycler::force_cleanup
+ * runs the remaining kernels and joins the device threads (thus it must not
+ * be called from within kernels) -- the next launch starts them again.
+ */
+class simulated_device {
+public:
+  /// Ordered queue of kernels (see simulated_stream_executor)
+  struct stream {
+    std::mutex mut;
+    std::deque<std::function<void()>> kernels{};
+    /// Is a kernel of this stream queued or running on the device?
+    bool active{false};
+  };
+
+  /// Replaces the configuration (only while no kernels are in flight)
+  static void configure(const simulated_device_config &new_config) {
+    auto &device = instance();
+    std::unique_lock<std::mutex> guard(device.device_mut);
+    if (device.kernels_in_flight != 0)
+      throw std::runtime_error(
+          "simulated_device: Configuration changed while kernels are running");
+    device.stop_device_threads(guard);
+    device.config = new_config;
+  }
+  static simulated_device_config get_config(void) {
+    auto &device = instance();
+    std::lock_guard<std::mutex> guard(device.device_mut);
+    return device.config;
+  }
+
+  static void *malloc(const size_t bytes) {
+    auto &device = instance();
+    std::lock_guard<std::mutex> malloc_guard(device.malloc_mut);
+    std::this_thread::sleep_for(get_config().malloc_latency);
+    void *data = std::malloc(bytes == 0 ? 1 : bytes);
+    if (data == nullptr)
+      throw std::bad_alloc{};
+    device.number_mallocs++;
+    return data;
+  }
+  static void free(void *p) {
+    auto &device = instance();
+    std::lock_guard<std::mutex> malloc_guard(device.malloc_mut);
+    {
+      std::unique_lock<std::mutex> guard(device.device_mut);
+      device.device_idle.wait(guard,
+                              [&device]() { return device.kernels_in_flight == 0; });
+    }
+    std::this_thread::sleep_for(get_config().free_latency);
+    std::free(p);
+    device.number_frees++;
+  }
+
+  /// Queues kernel on stream s -- runs once all previous kernels of s are done
+  static void launch(const std::shared_ptr<stream> &s,
+                     std::function<void()> kernel) {
+    auto &device = instance();
+    {
+      std::unique_lock<std::mutex> guard(device.device_mut);
+      device.start_device_threads(guard);
+      device.kernels_in_flight++;
+    }
+    bool schedule_stream = false;
+    {
+      std::lock_guard<std::mutex> stream_guard(s->mut);
+      s->kernels.push_back(std::move(kernel));
+      schedule_stream = !std::exchange(s->active, true);
+    }
+    if (schedule_stream)
+      device.schedule(s);
+  }
+
+  static size_t get_number_mallocs(void) { return instance().number_mallocs; }
+  static size_t get_number_frees(void) { return instance().number_frees; }
+  static size_t get_number_kernels(void) { return instance().number_kernels; }
+  static size_t get_number_device_threads(void) {
+    auto &device = instance();
+    std::lock_guard<std::mutex> guard(device.device_mut);
+    return device.device_threads.size();
+  }
+
+private:
+  simulated_device_config config{};
+  /// Serializes allocations and deallocations device-wide
+  std::mutex malloc_mut;
+  /// Protects everything below
+  std::mutex device_mut;
+  std::condition_variable device_idle;
+  std::condition_variable streams_ready;
+  std::condition_variable threads_stopped;
+  /// Streams with a kernel ready to run (one entry per active stream)
+  std::deque<std::shared_ptr<stream>> ready_streams{};
+  std::vector<std::thread> device_threads{};
+  size_t kernels_in_flight{0};
+  /// Set until the stopped device threads are joined
+  bool stopping{false};
+
+  std::atomic<size_t> number_mallocs{0};
+  std::atomic<size_t> number_frees{0};
+  std::atomic<size_t> number_kernels{0};
+
+  /// Leaked on purpose: recycled buffers may still get freed during the
+  /// static destruction of the buffer managers (the device threads are
+  /// joined by recycler::force_cleanup though)
+  static simulated_device &instance(void) {
+    static simulated_device *device = new simulated_device{};
+    return *device;
+  }
+  simulated_device() {
+    buffer_recycler::add_total_cleanup_callback([this]() {
+      std::unique_lock<std::mutex> guard(device_mut);
+      stop_device_threads(guard);
+    });
+  }
+
+  /// Waits for a stop in progress: its device threads need to see stopping
+  /// until they are joined
+  void start_device_threads(std::unique_lock<std::mutex> &guard) {
+    threads_stopped.wait(guard, [this]() { return !stopping; });
+    if (!device_threads.empty())
+      return;
+    for (size_t i = 0; i < std::max<size_t>(config.max_concurrent_kernels, 1);
+         i++)
+      device_threads.emplace_back([this]() { run_device_thread(); });
+  }
+  void stop_device_threads(std::unique_lock<std::mutex> &guard) {
+    threads_stopped.wait(guard, [this]() { return !stopping; });
+    stopping = true;
+    streams_ready.notify_all();
+    std::vector<std::thread> threads = std::move(device_threads);
+    device_threads.clear();
+    guard.unlock();
+    for (auto &thread : threads)
+      thread.join();
+    guard.lock();
+    stopping = false;
+    threads_stopped.notify_all();
+  }
+  void schedule(const std::shared_ptr<stream> &s) {
+    {
+      std::lock_guard<std::mutex> guard(device_mut);
+      ready_streams.push_back(s);
+    }
+    streams_ready.notify_one();
+  }
+
+  void run_device_thread(void) {
+    while (true) {
+      std::shared_ptr<stream> s;
+      std::chrono::microseconds kernel_latency;
+      {
+        std::unique_lock<std::mutex> guard(device_mut);
+        streams_ready.wait(
+            guard, [this]() { return stopping || !ready_streams.empty(); });
+        if (ready_streams.empty())
+          return; // stopping
+        s = std::move(ready_streams.front());
+        ready_streams.pop_front();
+        kernel_latency = config.kernel_latency;
+      }
+      std::function<void()> kernel;
+      {
+        std::lock_guard<std::mutex> stream_guard(s->mut);
+        assert(s->active && !s->kernels.empty());
+        kernel = std::move(s->kernels.front());
+        s->kernels.pop_front();
+      }
+      std::this_thread::sleep_for(kernel_latency);
+      number_kernels++;
+      kernel(); // also signals the completion of the kernel
+
+      bool schedule_stream = false;
+      {
+        std::lock_guard<std::mutex> stream_guard(s->mut);
+        schedule_stream = !s->kernels.empty();
+        s->active = schedule_stream;
+      }
+      if (schedule_stream)
+        schedule(s);
+      {
+        std::lock_guard<std::mutex> guard(device_mut);
+        kernels_in_flight--;
+        if (kernels_in_flight == 0)
+          device_idle.notify_all();
+      }
+    }
+  }
+
+public:
+  simulated_device(simulated_device const &other) = delete;
+  simulated_device &operator=(simulated_device const &other) = delete;
+  simulated_device(simulated_device &&other) = delete;
+  simulated_device &operator=(simulated_device &&other) = delete;
+};
+
+template <class T> struct simulated_device_allocator {
+  using value_type = T;
+  simulated_device_allocator() noexcept = default;
+  template <class U>
+  explicit simulated_device_allocator(
+      simulated_device_allocator<U> const &) noexcept {}
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(simulated_device::malloc(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t n) { simulated_device::free(p); }
+};
+template <class T, class U>
+constexpr bool operator==(simulated_device_allocator<T> const &,
+                          simulated_device_allocator<U> const &) noexcept {
+  return true;
+}
+template <class T, class U>
+constexpr bool operator!=(simulated_device_allocator<T> const &,
+                          simulated_device_allocator<U> const &) noexcept {
+  return false;
+}
+
+} // end namespace detail
+
+/// Configures the simulated device -- not while kernels are in flight
+inline void configure_simulated_device(const simulated_device_config &config) {
+  detail::simulated_device::configure(config);
+}
+
+template <typename T, std::enable_if_t<std::is_trivial<T>::value, int> = 0>
+using recycle_allocator_simulated_device =
+    detail::recycle_allocator<T, detail::simulated_device_allocator<T>>;
+
+#ifdef CPPUDDLE_HAVE_HPX
+/// Executor for one stream of the simulated device (usable in the stream
+/// pools and as underlying executor of the aggregated executors)
+/** Copies share the stream (like copies of the HPX CUDA executor). The
+ * futures get ready once the kernel ran on the device.
+ */
+class simulated_stream_executor {
+private:
+  std::shared_ptr<detail::simulated_device::stream> stream;
+  size_t gpu_id{0};
+
+public:
+  explicit simulated_stream_executor(size_t gpu_id = 0)
+      : stream(std::make_shared<detail::simulated_device::stream>()),
+        gpu_id(gpu_id) {}
+
+  size_t get_gpu_id(void) const noexcept { return gpu_id; }
+
+  /// Future that gets ready once all kernels launched so far are done
+  hpx::lcos::future<void> get_future(void) {
+    return async_execute([]() {});
+  }
+
+  template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    detail::simulated_device::launch(
+        stream, [call = std::make_shared<std::tuple<std::decay_t<F>,
+                                                    std::decay_t<Ts>...>>(
+                     std::forward<F>(f), std::forward<Ts>(ts)...)]() {
+          // Nobody waits for posted kernels: A failure must not terminate the
+          // device thread, it is dropped (like the error of an unchecked
+          // asynchronous CUDA launch)
+          try {
+            std::apply([](auto &f, auto &...ts) { std::invoke(f, ts...); }, *call);
+          } catch (...) {
+          }
+        });
+  }
+
+  template <typename F, typename... Ts>
+  hpx::lcos::future<std::invoke_result_t<std::decay_t<F> &, std::decay_t<Ts> &...>>
+  async_execute(F &&f, Ts &&...ts) {
+    using result_t =
+        std::invoke_result_t<std::decay_t<F> &, std::decay_t<Ts> &...>;
+    auto promise = std::make_shared<hpx::lcos::local::promise<result_t>>();
+    auto fut = promise->get_future();
+    detail::simulated_device::launch(
+        stream, [promise, call = std::make_shared<std::tuple<
+                              std::decay_t<F>, std::decay_t<Ts>...>>(
+                              std::forward<F>(f), std::forward<Ts>(ts)...)]() {
+          try {
+            if constexpr (std::is_void_v<result_t>) {
+              std::apply([](auto &f, auto &...ts) { std::invoke(f, ts...); }, *call);
+              promise->set_value();
+            } else {
+              promise->set_value(std::apply(
+                  [](auto &f, auto &...ts) { return std::invoke(f, ts...); }, *call));
+            }
+          } catch (...) {
+            promise->set_exception(std::current_exception());
+          }
+        });
+    return fut;
+  }
+
+  // OneWay Execution
+  template <typename F, typename... Ts>
+  friend decltype(auto) tag_invoke(hpx::parallel::execution::post_t,
+                                   simulated_stream_executor &exec, F &&f,
+                                   Ts &&...ts) {
+    return exec.post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  // TwoWay Execution
+  template <typename F, typename... Ts>
+  friend decltype(auto) tag_invoke(hpx::parallel::execution::async_execute_t,
+                                   simulated_stream_executor &exec, F &&f,
+                                   Ts &&...ts) {
+    return exec.async_execute(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+};
+#endif
+
+} // end namespace recycler
+
+#ifdef CPPUDDLE_HAVE_HPX
+namespace hpx { namespace parallel { namespace execution {
+    template <>
+    struct is_one_way_executor<recycler::simulated_stream_executor>
+      : std::true_type
+    {};
+    template <>
+    struct is_two_way_executor<recycler::simulated_stream_executor>
+      : std::true_type
+    {};
+}}}
+#endif
+
+#endif
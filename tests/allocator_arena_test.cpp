@@ -0,0 +1,281 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/arena_buffer_util.hpp"
+#include "../include/buffer_manager.hpp"
+#ifdef CPPUDDLE_HAVE_HPX
+#include <hpx/hpx_init.hpp>
+#endif
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Allocations that reached the counting_allocators (of any value type)
+std::atomic<size_t> number_underlying_allocations{0};
+std::atomic<size_t> number_underlying_deallocations{0};
+
+/// Host allocator standing in for a device allocator
+template <class T> struct counting_allocator {
+  using value_type = T;
+  counting_allocator() noexcept = default;
+  template <class U>
+  explicit counting_allocator(counting_allocator<U> const &) noexcept {}
+  T *allocate(std::size_t n) {
+    number_underlying_allocations++;
+    return std::allocator<T>{}.allocate(n);
+  }
+  void deallocate(T *p, std::size_t n) {
+    number_underlying_deallocations++;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+};
+template <class T, class U>
+constexpr bool operator==(counting_allocator<T> const &,
+                          counting_allocator<U> const &) noexcept {
+  return true;
+}
+template <class T, class U>
+constexpr bool operator!=(counting_allocator<T> const &,
+                          counting_allocator<U> const &) noexcept {
+  return false;
+}
+
+/// Counting allocator on a switchable (simulated) current device
+template <class T> struct device_counting_allocator : counting_allocator<T> {
+  static inline size_t current_device{0};
+  device_counting_allocator() noexcept = default;
+  template <class U>
+  explicit device_counting_allocator(
+      device_counting_allocator<U> const &) noexcept {}
+  static size_t get_device_id(void) { return current_device; }
+};
+template <class T, class U>
+constexpr bool operator==(device_counting_allocator<T> const &,
+                          device_counting_allocator<U> const &) noexcept {
+  return true;
+}
+template <class T, class U>
+constexpr bool operator!=(device_counting_allocator<T> const &,
+                          device_counting_allocator<U> const &) noexcept {
+  return false;
+}
+
+constexpr size_t block_size = size_t{1} << 20;
+constexpr size_t min_size = 256;
+using arena_t =
+    recycler::detail::arena_allocator<double, counting_allocator<double>,
+                                      block_size, min_size>;
+
+#ifdef CPPUDDLE_HAVE_HPX
+int hpx_main(int argc, char *argv[]) {
+#else
+int main(int argc, char *argv[]) {
+#endif
+
+  size_t number_allocations = 2000;
+  size_t max_array_size = 20000;
+  std::string filename{};
+
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "allocations",
+        boost::program_options::value<size_t>(&number_allocations)
+            ->default_value(2000),
+        "Number of random allocations/deallocations on the arena")(
+        "max_arraysize",
+        boost::program_options::value<size_t>(&max_array_size)
+            ->default_value(20000),
+        "Maximal size of the random allocations")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --allocations = " << number_allocations << std::endl
+                << " --max_arraysize = " << max_array_size << std::endl
+                << " --filename = " << filename << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+
+  bool results_correct = true;
+
+  // Random allocations: Sub-allocations are aligned and never overlap (each
+  // one keeps its own fill pattern), all blocks go back in the end
+  {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> size_dist(1, max_array_size);
+    std::vector<std::pair<double *, size_t>> live_buffers;
+    arena_t alloc;
+    for (size_t i = 0; i < number_allocations; i++) {
+      if (!live_buffers.empty() && gen() % 3 == 0) {
+        const size_t index = gen() % live_buffers.size();
+        auto [buffer, size] = live_buffers[index];
+        for (size_t j = 0; j < size; j++) {
+          if (buffer[j] !=
+              static_cast<double>(reinterpret_cast<uintptr_t>(buffer))) {
+            std::cout << "ERROR: Overlapping sub-allocations" << std::endl;
+            results_correct = false;
+            break;
+          }
+        }
+        alloc.deallocate(buffer, size);
+        live_buffers[index] = live_buffers.back();
+        live_buffers.pop_back();
+      } else {
+        const size_t size = size_dist(gen);
+        double *buffer = alloc.allocate(size);
+        if (reinterpret_cast<uintptr_t>(buffer) % alignof(double) != 0) {
+          std::cout << "ERROR: Misaligned sub-allocation" << std::endl;
+          results_correct = false;
+        }
+        for (size_t j = 0; j < size; j++)
+          buffer[j] = static_cast<double>(reinterpret_cast<uintptr_t>(buffer));
+        live_buffers.emplace_back(buffer, size);
+      }
+    }
+    std::cout << "\n==> Blocks held for " << live_buffers.size()
+              << " live sub-allocations: " << arena_t::get_number_blocks()
+              << std::endl;
+    for (auto [buffer, size] : live_buffers)
+      alloc.deallocate(buffer, size);
+    if (arena_t::get_number_blocks() != 0 ||
+        number_underlying_allocations != number_underlying_deallocations) {
+      std::cout << "ERROR: Arena did not return all blocks" << std::endl;
+      results_correct = false;
+    }
+  }
+
+  // Requests larger than a block get dedicated allocations
+  {
+    arena_t alloc;
+    const size_t allocations_before = arena_t::get_number_block_allocations();
+    double *large_buffer = alloc.allocate(block_size);
+    double *small_buffer = alloc.allocate(1);
+    large_buffer[block_size - 1] = 1.0;
+    if (arena_t::get_number_block_allocations() - allocations_before != 2 ||
+        arena_t::get_number_blocks() != 2) {
+      std::cout << "ERROR: Large request did not get a dedicated allocation"
+                << std::endl;
+      results_correct = false;
+    }
+    alloc.deallocate(large_buffer, block_size);
+    alloc.deallocate(small_buffer, 1);
+    if (arena_t::get_number_blocks() != 0) {
+      std::cout << "ERROR: Dedicated allocation did not get returned"
+                << std::endl;
+      results_correct = false;
+    }
+  }
+
+  // Arenas are single-device: Requests from another device get rejected
+  {
+    using device_arena_t =
+        recycler::detail::arena_allocator<double,
+                                          device_counting_allocator<double>,
+                                          block_size, min_size>;
+    device_arena_t alloc;
+    double *buffer = alloc.allocate(1);
+    device_counting_allocator<double>::current_device = 1;
+    bool rejected = false;
+    try {
+      double *other_device_buffer = alloc.allocate(1);
+      alloc.deallocate(other_device_buffer, 1);
+    } catch (const std::runtime_error &) {
+      rejected = true;
+    }
+    device_counting_allocator<double>::current_device = 0;
+    alloc.deallocate(buffer, 1);
+    if (!rejected) {
+      std::cout << "ERROR: Arena served a second device" << std::endl;
+      results_correct = false;
+    }
+  }
+
+  // Below the recycler: Many distinct buffer sizes share a few blocks of the
+  // underlying allocator, until the cleanup
+  {
+    using recycle_arena_t =
+        recycler::recycle_allocator_arena<double, counting_allocator<double>>;
+    using default_arena_t =
+        recycler::detail::arena_allocator<double, counting_allocator<double>>;
+    const size_t underlying_before = number_underlying_allocations;
+    constexpr size_t distinct_sizes = 64;
+    std::vector<std::vector<double, recycle_arena_t>> buffers;
+    for (size_t pass = 0; pass < 2; pass++) {
+      for (size_t i = 1; i <= distinct_sizes; i++)
+        buffers.emplace_back(i * 1000, static_cast<double>(i));
+      for (size_t i = 1; i <= distinct_sizes; i++) {
+        if (buffers[i - 1].back() != static_cast<double>(i)) {
+          std::cout << "ERROR: Wrong value in recycled arena buffer"
+                    << std::endl;
+          results_correct = false;
+        }
+      }
+      buffers.clear();
+    }
+    const size_t underlying_allocations =
+        number_underlying_allocations - underlying_before;
+    std::cout << "\n==> Underlying allocations for " << distinct_sizes
+              << " distinct buffer sizes: " << underlying_allocations
+              << std::endl;
+    if (underlying_allocations == 0 ||
+        underlying_allocations >= distinct_sizes) {
+      std::cout << "ERROR: Arena did not reduce the underlying allocations"
+                << std::endl;
+      results_correct = false;
+    }
+    recycler::force_cleanup(); // Cleanup all buffers and the managers
+    if (default_arena_t::get_number_blocks() != 0) {
+      std::cout << "ERROR: Arena kept blocks after the recycler cleanup"
+                << std::endl;
+      results_correct = false;
+    }
+  }
+
+  if (results_correct)
+    std::cout << "SUCCESS: Arena sub-allocations were disjoint and all blocks "
+                 "got returned"
+              << std::endl;
+#ifdef CPPUDDLE_HAVE_HPX
+  return hpx::finalize();
+#else
+  return EXIT_SUCCESS;
+#endif
+}
+
+#ifdef CPPUDDLE_HAVE_HPX
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
+#endif
@@ -0,0 +1,247 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#include "../include/buffer_manager.hpp"
+#include "../include/kokkos_buffer_util.hpp"
+#include "../include/kokkos_scratch_util.hpp"
+#include <boost/program_options.hpp>
+
+// Assert during Release builds as well for this file:
+#undef NDEBUG
+#include <cassert> // reinclude the header to update the definition of assert()
+
+constexpr size_t view_size_0 = 10;
+constexpr size_t view_size_1 = 50;
+constexpr size_t league_size = 8;
+constexpr size_t elements_per_team = 64;
+
+// Counts the heap allocations of each thread (for the benchmark below)
+thread_local size_t heap_allocations = 0;
+void *operator new(std::size_t size) {
+  heap_allocations++;
+  if (void *p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc{};
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using executor_t = hpx::kokkos::serial_executor;
+using execution_space_t =
+    std::decay_t<decltype(std::declval<executor_t &>().instance())>;
+using result_view_t = Kokkos::View<double *, Kokkos::HostSpace>;
+using temporary_view_t = Kokkos::View<double **, Kokkos::HostSpace>;
+using team_scratch_view_t = Kokkos::View<double **, Kokkos::HostSpace>;
+
+// Scratch part of a team: Subview of the team row or the recycled team scratch
+template <typename TeamMember>
+auto get_team_view(const team_scratch_view_t &team_scratch,
+                   const TeamMember &team) {
+  return Kokkos::subview(team_scratch, team.league_rank(), Kokkos::ALL);
+}
+template <typename TeamMember>
+auto get_team_view(
+    const recycler::recycled_team_scratch<double, execution_space_t> &team_scratch,
+    const TeamMember &team) {
+  return team_scratch.team_view(team);
+}
+
+/// One kernel invocation: Fills a temporary 2D view with an MDRange and
+/// reduces the scratch of each team into results
+template <typename TemporaryView, typename TeamScratch>
+void run_kernels(executor_t &executor, const TemporaryView &temporary,
+                 const TeamScratch &team_scratch, const result_view_t &results,
+                 const double value) {
+  auto policy_1 = Kokkos::Experimental::require(
+      Kokkos::MDRangePolicy<execution_space_t, Kokkos::Rank<2>>(
+          executor.instance(), {0, 0}, {view_size_0, view_size_1}),
+      Kokkos::Experimental::WorkItemProperty::HintLightWeight);
+  Kokkos::parallel_for(
+      "temporary init", policy_1,
+      KOKKOS_LAMBDA(int n, int o) { temporary(n, o) = value + n; });
+
+  using member_type = typename Kokkos::TeamPolicy<execution_space_t>::member_type;
+  Kokkos::parallel_for(
+      "team scratch", Kokkos::TeamPolicy<execution_space_t>(
+                          executor.instance(), league_size, Kokkos::AUTO),
+      KOKKOS_LAMBDA(const member_type &team) {
+        const int rank = team.league_rank();
+        auto team_view = get_team_view(team_scratch, team);
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, elements_per_team),
+                             [&](const int i) {
+                               team_view(i) =
+                                   temporary(rank % view_size_0, 0) + i;
+                             });
+        team.team_barrier();
+        double sum = 0.0;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(team, elements_per_team),
+            [&](const int i, double &partial_sum) {
+              partial_sum += team_view(i);
+            },
+            sum);
+        Kokkos::single(Kokkos::PerTeam(team), [&]() { results(rank) = sum; });
+      });
+  executor.instance().fence();
+}
+
+bool check_results(const result_view_t &results, const double value) {
+  for (size_t rank = 0; rank < league_size; rank++) {
+    const double expected =
+        elements_per_team * (value + rank % view_size_0) +
+        elements_per_team * (elements_per_team - 1) / 2.0;
+    if (results(rank) != expected)
+      return false;
+  }
+  return true;
+}
+
+int hpx_main(int argc, char *argv[]) {
+  std::string filename{};
+  size_t passes = 1000;
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file")(
+        "passes",
+        boost::program_options::value<size_t>(&passes)->default_value(1000),
+        "Number of kernel invocations per benchmark loop");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --filename = " << filename << std::endl
+                << " --passes = " << passes << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return hpx::finalize();
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+
+  {
+    hpx::kokkos::ScopeGuard g(argc, argv);
+    Kokkos::print_configuration(std::cout);
+
+    executor_t executor;
+    result_view_t results("results", league_size);
+    bool results_correct = true;
+
+    // Baseline: The same kernels with views allocated once (heap allocations
+    // of the kernel launches themselves)
+    temporary_view_t persistent_temporary("temporary", view_size_0,
+                                          view_size_1);
+    team_scratch_view_t persistent_scratch("scratch", league_size,
+                                           elements_per_team);
+    run_kernels(executor, persistent_temporary, persistent_scratch, results,
+                0.0); // warmup
+    size_t launch_allocations = heap_allocations;
+    for (size_t pass = 0; pass < passes; pass++) {
+      run_kernels(executor, persistent_temporary, persistent_scratch, results,
+                  pass);
+      results_correct &= check_results(results, pass);
+    }
+    launch_allocations = heap_allocations - launch_allocations;
+
+    // Temporaries allocated by Kokkos within each invocation
+    size_t managed_allocations = heap_allocations;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (size_t pass = 0; pass < passes; pass++) {
+      temporary_view_t temporary("temporary", view_size_0, view_size_1);
+      team_scratch_view_t team_scratch("scratch", league_size,
+                                       elements_per_team);
+      run_kernels(executor, temporary, team_scratch, results, pass);
+      results_correct &= check_results(results, pass);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    managed_allocations = heap_allocations - managed_allocations;
+    const double managed_time =
+        std::chrono::duration<double, std::nano>(end - begin).count() / passes;
+
+    // Recycled temporaries and team scratch within each invocation
+    std::array<double *, 2> recycled_buffers{};
+    {
+      auto temporary = recycler::make_temporary_view<double **>(view_size_0,
+                                                                view_size_1);
+      recycler::recycled_team_scratch<double, execution_space_t> team_scratch(
+          league_size, elements_per_team);
+      run_kernels(executor, temporary, team_scratch, results, 0.0); // warmup
+      recycled_buffers = {temporary.data(), team_scratch.data()};
+    }
+    size_t new_buffers = 0;
+    size_t recycled_allocations = heap_allocations;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t pass = 0; pass < passes; pass++) {
+      auto temporary = recycler::make_temporary_view<double **>(view_size_0,
+                                                                view_size_1);
+      recycler::recycled_team_scratch<double, execution_space_t> team_scratch(
+          league_size, elements_per_team);
+      run_kernels(executor, temporary, team_scratch, results, pass);
+      results_correct &= check_results(results, pass);
+      if (temporary.data() != recycled_buffers[0] ||
+          team_scratch.data() != recycled_buffers[1])
+        new_buffers++;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    recycled_allocations = heap_allocations - recycled_allocations;
+    const double recycled_time =
+        std::chrono::duration<double, std::nano>(end - begin).count() / passes;
+
+    if (!results_correct)
+      std::cout << "ERROR: Wrong kernel results" << std::endl;
+    std::cout << "Kernel launches: " << launch_allocations
+              << " heap allocations for " << passes << " invocations"
+              << std::endl;
+    std::cout << "Managed temporaries: " << managed_time
+              << " ns per invocation (" << managed_allocations
+              << " heap allocations)" << std::endl;
+    std::cout << "Recycled temporaries: " << recycled_time
+              << " ns per invocation (" << recycled_allocations
+              << " heap allocations)" << std::endl;
+    const size_t additional_allocations =
+        recycled_allocations > launch_allocations
+            ? recycled_allocations - launch_allocations
+            : 0;
+    std::cout << "==> Additional heap allocations per kernel invocation: "
+              << static_cast<double>(additional_allocations) / passes
+              << std::endl;
+    std::cout << "==> Invocations with new temporary buffers: " << new_buffers
+              << std::endl;
+    recycler::force_cleanup();
+  }
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
@@ -16,13 +16,31 @@
 #include "../include/buffer_manager.hpp"
 #include "../include/cuda_buffer_util.hpp"
 #include "../include/kokkos_buffer_util.hpp"
+#ifdef CPPUDDLE_HAVE_KOKKOS_RECYCLED_SPACE
+#include "../include/kokkos_recycled_space.hpp"
+#endif
 #ifdef CPPUDDLE_HAVE_HPX  
 #include <hpx/hpx_init.hpp>
 #endif
 #include <boost/program_options.hpp>
 #include <hpx/timing/high_resolution_timer.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdlib>
 #include <memory>
+#include <new>
+#include <set>
+
+// Counts the heap allocations of each thread (for the view benchmark below)
+thread_local size_t heap_allocations = 0;
+void *operator new(std::size_t size) {
+  heap_allocations++;
+  if (void *p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc{};
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 using kokkos_array =
     Kokkos::View<float[1000], Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
@@ -90,6 +108,79 @@ int main(int argc, char *argv[]) {
                         });
     Kokkos::fence();
   }
+
+  // Benchmark: Recycler requests and heap allocations of a view creation
+  // (plus one copy and one move) -- copies and moves should not touch the
+  // recycler, all buffers should be recycled and the reference counting of
+  // the views should not allocate. Uses double views to keep the float
+  // recycler statistics above as they are
+  constexpr size_t benchmark_views = 10000;
+  constexpr size_t benchmark_elements = 1000;
+  { test_double_view warmup(benchmark_elements); }
+  const auto stats_before = recycler::detail::buffer_recycler::get_statistics<
+      double, std::allocator<double>>();
+  const size_t heap_allocations_before = heap_allocations;
+  const auto begin = std::chrono::high_resolution_clock::now();
+  for (size_t view = 0; view < benchmark_views; view++) {
+    test_double_view my_view(benchmark_elements);
+    test_double_view my_copy(my_view);
+    test_double_view my_moved(std::move(my_copy));
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+  const size_t view_heap_allocations =
+      heap_allocations - heap_allocations_before;
+  const auto stats_after = recycler::detail::buffer_recycler::get_statistics<
+      double, std::allocator<double>>();
+  const size_t view_requests =
+      stats_after.number_allocation - stats_before.number_allocation;
+  const size_t view_creations =
+      stats_after.number_creation - stats_before.number_creation;
+  std::cout << "View benchmark: "
+            << std::chrono::duration<double, std::nano>(end - begin).count() /
+                   benchmark_views
+            << " ns per view creation (" << view_requests
+            << " recycler requests for " << benchmark_views << " views)"
+            << std::endl;
+  std::cout << "==> Recycler requests per view: "
+            << static_cast<double>(view_requests) / benchmark_views
+            << std::endl;
+  std::cout << "==> New buffers during the view benchmark: " << view_creations
+            << std::endl;
+  std::cout << "==> Heap allocations per view: "
+            << static_cast<double>(view_heap_allocations) / benchmark_views
+            << std::endl;
+  if (view_heap_allocations != 0)
+    std::cout << "ERROR: " << view_heap_allocations
+              << " heap allocations during the view benchmark" << std::endl;
+
+#ifdef CPPUDDLE_HAVE_KOKKOS_RECYCLED_SPACE
+  // Managed views (and mirrors) in the recycled memory space: All passes
+  // should reuse the same two buffers
+  {
+    using recycled_managed_view =
+        Kokkos::View<double **, recycler::RecycledHostSpace>;
+    Kokkos::View<double **, Kokkos::HostSpace> host_view("host_view", 10, 100);
+    std::set<double *> managed_buffers;
+    bool managed_correct = true;
+    for (size_t pass = 0; pass < passes; pass++) {
+      recycled_managed_view managed_view("managed_view", 10, 100);
+      Kokkos::deep_copy(managed_view, static_cast<double>(pass));
+      Kokkos::deep_copy(host_view, managed_view);
+      auto mirror_view =
+          Kokkos::create_mirror_view(recycler::RecycledHostSpace{}, host_view);
+      Kokkos::deep_copy(mirror_view, host_view);
+      if (mirror_view(9, 99) != static_cast<double>(pass))
+        managed_correct = false;
+      managed_buffers.insert(managed_view.data());
+      managed_buffers.insert(mirror_view.data());
+    }
+    if (!managed_correct)
+      std::cout << "ERROR: Wrong values in the recycled managed views"
+                << std::endl;
+    std::cout << "==> Distinct buffers of the recycled managed views: "
+              << managed_buffers.size() << std::endl;
+  }
+#endif
 #ifdef CPPUDDLE_HAVE_HPX  
   return hpx::finalize();
 #else
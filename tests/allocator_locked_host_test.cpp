@@ -0,0 +1,191 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/buffer_manager.hpp"
+#include "../include/locked_host_buffer_util.hpp"
+#ifdef CPPUDDLE_HAVE_HPX
+#include <hpx/hpx_init.hpp>
+#endif
+#include <boost/program_options.hpp>
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+/// Minor page faults of this process so far
+long number_page_faults(void) {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt;
+}
+
+/// Allocates and touches a fresh buffer each pass -- returns the page faults
+/// caused by touching the buffers
+template <typename Allocator>
+long count_touch_page_faults(const size_t array_size, const size_t passes) {
+  long page_faults = 0;
+  for (size_t pass = 0; pass < passes; pass++) {
+    Allocator alloc;
+    double *buffer = alloc.allocate(array_size);
+    const long faults_before = number_page_faults();
+    for (size_t i = 0; i < array_size; i++)
+      buffer[i] = static_cast<double>(i);
+    page_faults += number_page_faults() - faults_before;
+    // Print last element - Causes the compiler to not optimize out the entire
+    // loop
+    std::cout << buffer[array_size - 1] << " ";
+    alloc.deallocate(buffer, array_size);
+  }
+  std::cout << std::endl;
+  return page_faults;
+}
+
+#ifdef CPPUDDLE_HAVE_HPX
+int hpx_main(int argc, char *argv[]) {
+#else
+int main(int argc, char *argv[]) {
+#endif
+
+  size_t array_size = 1000000;
+  size_t passes = 20;
+  std::string filename{};
+
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "arraysize",
+        boost::program_options::value<size_t>(&array_size)
+            ->default_value(1000000),
+        "Size of the buffers")(
+        "passes",
+        boost::program_options::value<size_t>(&passes)->default_value(20),
+        "Sets the number of repetitions")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --arraysize = " << array_size << std::endl
+                << " --passes = " << passes << std::endl
+                << " --filename = " << filename << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+
+  assert(passes >= 1);     // NOLINT
+  assert(array_size >= 1); // NOLINT
+
+  using memory_t = recycler::detail::locked_host_memory;
+  bool results_correct = true;
+
+  // Recycled staging buffers of different sizes share the locked chunks
+  {
+    std::vector<
+        std::vector<double, recycler::recycle_allocator_locked_host<double>>>
+        buffers;
+    for (size_t i = 1; i <= 32; i++) {
+      buffers.emplace_back(i * 1000);
+      for (size_t j = 0; j < buffers.back().size(); j++)
+        buffers.back()[j] = static_cast<double>(i + j);
+    }
+    for (size_t i = 1; i <= 32; i++) {
+      if (buffers[i - 1].back() != static_cast<double>(i + i * 1000 - 1)) {
+        std::cout << "ERROR: Wrong value in locked host buffer" << std::endl;
+        results_correct = false;
+      }
+    }
+    std::cout << "\n==> Locked chunks: "
+              << memory_t::get_number_locked_mappings()
+              << ", unlocked chunks (RLIMIT_MEMLOCK exceeded): "
+              << memory_t::get_number_unlocked_mappings() << std::endl;
+    if (memory_t::get_number_locked_mappings() +
+            memory_t::get_number_unlocked_mappings() ==
+        0) {
+      std::cout << "ERROR: No host memory got mapped" << std::endl;
+      results_correct = false;
+    }
+  }
+
+  // Without any lockable memory left: Allocations still succeed (unlocked)
+  // unless the process may lock memory regardless (CAP_IPC_LOCK)
+  {
+    rlimit old_limit{};
+    getrlimit(RLIMIT_MEMLOCK, &old_limit);
+    rlimit no_limit = old_limit;
+    no_limit.rlim_cur = 0;
+    setrlimit(RLIMIT_MEMLOCK, &no_limit);
+    const size_t mappings_before = memory_t::get_number_locked_mappings() +
+                                   memory_t::get_number_unlocked_mappings();
+    recycler::detail::locked_host_allocator<double> alloc;
+    double *buffer = alloc.allocate(array_size);
+    buffer[array_size - 1] = 1.0;
+    alloc.deallocate(buffer, array_size);
+    setrlimit(RLIMIT_MEMLOCK, &old_limit);
+    if (memory_t::get_number_locked_mappings() +
+            memory_t::get_number_unlocked_mappings() !=
+        mappings_before + 1) {
+      std::cout << "ERROR: Allocation beyond RLIMIT_MEMLOCK did not get counted"
+                << std::endl;
+      results_correct = false;
+    }
+  }
+
+  // Page faults while touching the buffers (the locked ones are pre-faulted)
+  const long default_faults =
+      count_touch_page_faults<std::allocator<double>>(array_size, passes);
+  std::cout << "==> Page faults with std::allocator: " << default_faults
+            << std::endl;
+  const long locked_faults = count_touch_page_faults<
+      recycler::recycle_allocator_locked_host<double>>(array_size, passes);
+  std::cout << "==> Page faults with locked host allocator: " << locked_faults
+            << std::endl;
+  if (locked_faults > default_faults) {
+    std::cout << "ERROR: Locked host buffers were not pre-faulted" << std::endl;
+    results_correct = false;
+  } else if (locked_faults < default_faults) {
+    std::cout << "Test information: Locked host buffers caused fewer page "
+                 "faults than std::allocator!"
+              << std::endl;
+  }
+
+  recycler::force_cleanup(); // Cleanup all buffers and the managers
+  if (results_correct)
+    std::cout << "SUCCESS: Locked host buffers were usable and pre-faulted"
+              << std::endl;
+#ifdef CPPUDDLE_HAVE_HPX
+  return hpx::finalize();
+#else
+  return EXIT_SUCCESS;
+#endif
+}
+
+#ifdef CPPUDDLE_HAVE_HPX
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
+#endif
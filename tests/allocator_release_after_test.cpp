@@ -0,0 +1,171 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+
+#include <boost/program_options.hpp>
+
+#include "../include/buffer_manager.hpp"
+
+/// Dummy executor whose futures complete later (like the ones of a GPU
+/// stream): The work runs immediately, but its futures only get ready with
+/// complete_pending_work / fail_pending_work
+struct Delayed_Executor {
+  std::vector<hpx::lcos::local::promise<void>> pending_work;
+  template <typename F, typename... Ts>
+  hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+    f(std::forward<Ts>(ts)...);
+    pending_work.emplace_back();
+    return pending_work.back().get_future();
+  }
+  void complete_pending_work() {
+    for (auto &promise : pending_work)
+      promise.set_value();
+    pending_work.clear();
+  }
+  void fail_pending_work() {
+    for (auto &promise : pending_work)
+      promise.set_exception(
+          std::make_exception_ptr(std::runtime_error("work failed")));
+    pending_work.clear();
+  }
+};
+
+using buffer_t = std::vector<double, recycler::recycle_std<double>>;
+
+int hpx_main(int argc, char *argv[]) {
+  size_t array_size = 5000;
+  size_t number_buffers = 16;
+  std::string filename{};
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "arraysize",
+        boost::program_options::value<size_t>(&array_size)->default_value(5000),
+        "Size of the buffers")(
+        "buffers",
+        boost::program_options::value<size_t>(&number_buffers)
+            ->default_value(16),
+        "Number of buffers released at once")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --arraysize = " << array_size << std::endl
+                << " --buffers = " << number_buffers << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return hpx::finalize();
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+
+  bool results_correct = true;
+  Delayed_Executor executor;
+
+  // Buffer must not be recycled before the work completes
+  {
+    buffer_t buffer(array_size, 0.0);
+    double *buffer_data = buffer.data();
+    auto work_fut = executor.async(
+        [buffer_data, array_size]() { buffer_data[array_size - 1] = 1.0; });
+    auto release_fut =
+        recycler::release_after(std::move(buffer), std::move(work_fut));
+    {
+      buffer_t other_buffer(array_size, 0.0);
+      if (other_buffer.data() == buffer_data) {
+        std::cout << "ERROR: Buffer got recycled before its work completed"
+                  << std::endl;
+        results_correct = false;
+      }
+    }
+    if (release_fut.is_ready()) {
+      std::cout << "ERROR: Buffer got released before its work completed"
+                << std::endl;
+      results_correct = false;
+    }
+    executor.complete_pending_work();
+    release_fut.get();
+    buffer_t reused_buffer(array_size, 0.0);
+    if (reused_buffer.data() != buffer_data) {
+      std::cout << "ERROR: Buffer did not get recycled after its work completed"
+                << std::endl;
+      results_correct = false;
+    }
+  }
+
+  // Allocator support -- the release future carries the exception of the work
+  {
+    recycler::recycle_std<double> alloc;
+    double *buffer_data = alloc.allocate(array_size);
+    auto release_fut = alloc.deallocate_after(
+        buffer_data, array_size, executor.async([]() {}));
+    executor.fail_pending_work();
+    try {
+      release_fut.get();
+      std::cout << "ERROR: Exception of the work got lost" << std::endl;
+      results_correct = false;
+    } catch (const std::runtime_error &) {
+      // expected -- the buffer got released nevertheless
+    }
+    double *reused_data = alloc.allocate(array_size);
+    if (reused_data != buffer_data) {
+      std::cout << "ERROR: Buffer of failed work did not get recycled"
+                << std::endl;
+      results_correct = false;
+    }
+    alloc.deallocate(reused_data, array_size);
+  }
+
+  // Many buffers released at once (shared future of their work)
+  {
+    std::vector<hpx::lcos::future<void>> release_futs;
+    hpx::lcos::shared_future<void> work_fut =
+        executor.async([]() {}).share();
+    for (size_t i = 0; i < number_buffers; i++) {
+      buffer_t buffer(array_size, 0.0);
+      release_futs.emplace_back(
+          recycler::release_after(std::move(buffer), work_fut));
+    }
+    executor.complete_pending_work();
+    hpx::lcos::when_all(release_futs).get();
+  }
+
+  if (results_correct)
+    std::cout << "SUCCESS: All buffers got released after their work"
+              << std::endl;
+  recycler::force_cleanup(); // Cleanup all buffers and the managers
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
@@ -0,0 +1,255 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../include/aggregation_manager.hpp"
+#include "../include/buffer_manager.hpp"
+#include "../include/simulated_device_util.hpp"
+#include "../include/stream_manager.hpp"
+#include <boost/program_options.hpp>
+
+using executor_t = recycler::simulated_stream_executor;
+using pool_t = round_robin_pool<executor_t>;
+
+/// Each task gets a stream and a device buffer, fills the buffer with a kernel
+/// and checks the result -- returns the runtime in ms
+template <typename Allocator>
+double run_tasks(const size_t number_tasks, const size_t array_size,
+                 std::atomic<size_t> &wrong_values) {
+  auto begin = std::chrono::high_resolution_clock::now();
+  std::vector<hpx::lcos::future<void>> futs;
+  for (size_t task_id = 0; task_id < number_tasks; task_id++) {
+    futs.emplace_back(hpx::async([task_id, array_size, &wrong_values]() {
+      stream_interface<executor_t, pool_t> stream;
+      Allocator alloc;
+      double *device_buffer = alloc.allocate(array_size);
+      hpx::async(
+          stream.interface,
+          [task_id, array_size](double *buffer) {
+            for (size_t i = 0; i < array_size; i++)
+              buffer[i] = static_cast<double>(task_id + i);
+          },
+          device_buffer)
+          .get();
+      for (size_t i = 0; i < array_size; i++) {
+        if (device_buffer[i] != static_cast<double>(task_id + i))
+          wrong_values++;
+      }
+      alloc.deallocate(device_buffer, array_size);
+    }));
+  }
+  hpx::lcos::when_all(futs).get();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+std::atomic<size_t> aggregated_launches{0};
+void count_aggregated_launch(void) { aggregated_launches++; }
+
+int hpx_main(int argc, char *argv[]) {
+  std::string filename{};
+  size_t number_tasks = 200;
+  size_t array_size = 1000;
+  size_t number_streams = 4;
+  size_t max_slices = 4;
+  recycler::simulated_device_config config{};
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file")(
+        "tasks",
+        boost::program_options::value<size_t>(&number_tasks)
+            ->default_value(200),
+        "Number of tasks (one kernel each)")(
+        "arraysize",
+        boost::program_options::value<size_t>(&array_size)->default_value(1000),
+        "Size of the device buffer of each task")(
+        "streams",
+        boost::program_options::value<size_t>(&number_streams)
+            ->default_value(4),
+        "Number of simulated streams in the pool")(
+        "max_slices",
+        boost::program_options::value<size_t>(&max_slices)->default_value(4),
+        "Number of tasks aggregated into one kernel launch")(
+        "malloc_latency",
+        boost::program_options::value<size_t>()->default_value(100),
+        "Simulated device malloc latency [us]")(
+        "free_latency",
+        boost::program_options::value<size_t>()->default_value(100),
+        "Simulated device free latency [us]")(
+        "kernel_latency",
+        boost::program_options::value<size_t>()->default_value(20),
+        "Simulated kernel latency [us]")(
+        "max_concurrent_kernels",
+        boost::program_options::value<size_t>(&config.max_concurrent_kernels)
+            ->default_value(4),
+        "Kernels running concurrently on the simulated device");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+    config.malloc_latency =
+        std::chrono::microseconds(vm["malloc_latency"].as<size_t>());
+    config.free_latency =
+        std::chrono::microseconds(vm["free_latency"].as<size_t>());
+    config.kernel_latency =
+        std::chrono::microseconds(vm["kernel_latency"].as<size_t>());
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --filename = " << filename << std::endl
+                << " --tasks = " << number_tasks << std::endl
+                << " --arraysize = " << array_size << std::endl
+                << " --streams = " << number_streams << std::endl
+                << " --max_slices = " << max_slices << std::endl
+                << " --malloc_latency = " << config.malloc_latency.count()
+                << std::endl
+                << " --free_latency = " << config.free_latency.count()
+                << std::endl
+                << " --kernel_latency = " << config.kernel_latency.count()
+                << std::endl
+                << " --max_concurrent_kernels = "
+                << config.max_concurrent_kernels << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return hpx::finalize();
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+  recycler::configure_simulated_device(config);
+  stream_pool::init<executor_t, pool_t>(number_streams);
+
+  // Kernels of one stream run in order
+  {
+    stream_interface<executor_t, pool_t> stream;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < 10; i++)
+      hpx::apply(stream.interface, [&order, i]() { order.push_back(i); });
+    stream.interface.get_future().get();
+    for (size_t i = 0; i < 10; i++) {
+      if (order.size() != 10 || order[i] != i) {
+        std::cout << "ERROR: Kernels of a stream ran out of order" << std::endl;
+        break;
+      }
+    }
+  }
+
+  // A failing posted kernel must not take down the device (nobody waits for it)
+  {
+    stream_interface<executor_t, pool_t> stream;
+    bool kernel_ran = false;
+    hpx::apply(stream.interface,
+               []() { throw std::runtime_error("posted kernel failed"); });
+    hpx::async(stream.interface, [&kernel_ran]() { kernel_ran = true; }).get();
+    if (!kernel_ran)
+      std::cout << "ERROR: Stream stopped after a failing posted kernel"
+                << std::endl;
+  }
+
+  // Device allocations: Default allocator vs recycler
+  std::atomic<size_t> wrong_values{0};
+  const size_t mallocs_before = recycler::detail::simulated_device::get_number_mallocs();
+  const double default_duration =
+      run_tasks<recycler::detail::simulated_device_allocator<double>>(
+          number_tasks, array_size, wrong_values);
+  const size_t default_mallocs =
+      recycler::detail::simulated_device::get_number_mallocs() - mallocs_before;
+  std::cout << "\n==> Non-recycle device allocation test took "
+            << default_duration << "ms (" << default_mallocs
+            << " device mallocs)" << std::endl;
+  const double recycle_duration =
+      run_tasks<recycler::recycle_allocator_simulated_device<double>>(
+          number_tasks, array_size, wrong_values);
+  const size_t recycle_mallocs =
+      recycler::detail::simulated_device::get_number_mallocs() -
+      mallocs_before - default_mallocs;
+  std::cout << "\n==> Recycle device allocation test took " << recycle_duration
+            << "ms (" << recycle_mallocs << " device mallocs)" << std::endl;
+  if (wrong_values > 0)
+    std::cout << "ERROR: " << wrong_values << " wrong values in device buffers"
+              << std::endl;
+  if (recycle_mallocs >= default_mallocs)
+    std::cout << "ERROR: Recycler did not avoid device mallocs" << std::endl;
+
+  // Aggregation: One kernel launch for max_slices tasks
+  {
+    static const char kernelname[] = "simulated_kernel";
+    using executor_pool = aggregation_pool<kernelname, executor_t, pool_t>;
+    executor_pool::init(1, max_slices, Aggregated_Executor_Modes::STRICT);
+    const size_t kernels_before =
+        recycler::detail::simulated_device::get_number_kernels();
+    const size_t aggregated_tasks = max_slices * 8;
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    for (size_t task_id = 0; task_id < aggregated_tasks; task_id++) {
+      auto slice_fut = executor_pool::request_executor_slice();
+      if (!slice_fut.has_value()) {
+        std::cout << "ERROR: Executor slice was not created properly"
+                  << std::endl;
+        continue;
+      }
+      slices_done_futs.emplace_back(slice_fut.value().then([](auto &&fut) {
+        auto slice_exec = fut.get();
+        slice_exec.async(count_aggregated_launch).get();
+      }));
+    }
+    hpx::lcos::when_all(slices_done_futs).get();
+    const size_t device_kernels =
+        recycler::detail::simulated_device::get_number_kernels() -
+        kernels_before;
+    std::cout << "\n==> Aggregated tasks: " << aggregated_tasks
+              << ", device kernel launches: " << device_kernels << std::endl;
+    if (aggregated_launches != aggregated_tasks / max_slices ||
+        device_kernels != aggregated_launches)
+      std::cout << "ERROR: Wrong number of aggregated kernel launches"
+                << std::endl;
+  }
+  stream_pool::cleanup<executor_t, pool_t>();
+
+  if (recycle_duration < default_duration) {
+    std::cout << "Test information: Recycler was faster than default allocator!"
+              << std::endl;
+  }
+  // Kernels launched while the cleanup joins the device threads
+  {
+    executor_t executor;
+    auto launches_done = hpx::async([&executor]() {
+      std::vector<hpx::lcos::future<void>> futs;
+      for (size_t i = 0; i < 100; i++)
+        futs.emplace_back(hpx::async(executor, []() {}));
+      hpx::lcos::when_all(futs).get();
+    });
+    recycler::force_cleanup();
+    launches_done.get();
+  }
+  recycler::force_cleanup(); // Cleanup all buffers and the managers
+  if (recycler::detail::simulated_device::get_number_device_threads() != 0)
+    std::cout << "ERROR: Device threads still running after the cleanup"
+              << std::endl;
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+
+#include <boost/program_options.hpp>
+
+#include "../include/buffer_manager.hpp"
+
+/// Dummy executor whose futures complete later (like the ones of a GPU
+/// stream): The work runs immediately, but its futures only get ready with
+/// complete_pending_work. Copies share the (dummy) stream.
+struct Delayed_Executor {
+  struct stream_t {
+    std::vector<hpx::lcos::local::promise<void>> pending_work;
+  };
+  std::shared_ptr<stream_t> stream = std::make_shared<stream_t>();
+
+  const stream_t *get_stream() const { return stream.get(); }
+  template <typename F, typename... Ts>
+  hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+    f(std::forward<Ts>(ts)...);
+    stream->pending_work.emplace_back();
+    return stream->pending_work.back().get_future();
+  }
+  void complete_pending_work() {
+    for (auto &promise : stream->pending_work)
+      promise.set_value();
+    stream->pending_work.clear();
+  }
+};
+
+int hpx_main(int argc, char *argv[]) {
+  size_t array_size = 5000;
+  size_t number_buffers = 16;
+  std::string filename{};
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "arraysize",
+        boost::program_options::value<size_t>(&array_size)->default_value(5000),
+        "Size of the buffers")(
+        "buffers",
+        boost::program_options::value<size_t>(&number_buffers)
+            ->default_value(16),
+        "Number of buffers per stream")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --arraysize = " << array_size << std::endl
+                << " --buffers = " << number_buffers << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return hpx::finalize();
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+
+  bool results_correct = true;
+  // Two streams whose work completes later
+  Delayed_Executor executor_a;
+  Delayed_Executor executor_b;
+  recycler::recycle_std<double> alloc;
+
+  // Same stream: Reusable right away (stream ordering)
+  double *buffer_a = alloc.allocate_on_stream(array_size, executor_a);
+  alloc.deallocate_on_stream(
+      buffer_a, array_size, executor_a,
+      executor_a.async([buffer_a, array_size]() { buffer_a[0] = 1.0; }));
+  double *same_stream_buffer = alloc.allocate_on_stream(array_size, executor_a);
+  if (same_stream_buffer != buffer_a) {
+    std::cout << "ERROR: Buffer did not get reused on its own stream"
+              << std::endl;
+    results_correct = false;
+  }
+  alloc.deallocate_on_stream(same_stream_buffer, array_size, executor_a,
+                             executor_a.async([]() {}));
+  // Copies of the executor work on the same stream
+  const Delayed_Executor executor_a_copy = executor_a;
+  double *copied_stream_buffer =
+      alloc.allocate_on_stream(array_size, executor_a_copy);
+  if (copied_stream_buffer != buffer_a) {
+    std::cout << "ERROR: Buffer did not get reused by a copy of its executor"
+              << std::endl;
+    results_correct = false;
+  }
+  alloc.deallocate_on_stream(copied_stream_buffer, array_size, executor_a,
+                             executor_a.async([]() {}));
+
+  // Other stream (and no stream): Not while the work of stream a is pending
+  double *buffer_b = alloc.allocate_on_stream(array_size, executor_b);
+  double *unstreamed_buffer = alloc.allocate(array_size);
+  if (buffer_b == buffer_a || unstreamed_buffer == buffer_a) {
+    std::cout << "ERROR: Buffer got reused by another stream before its work "
+                 "completed"
+              << std::endl;
+    results_correct = false;
+  }
+  alloc.deallocate_on_stream(buffer_b, array_size, executor_b,
+                             executor_b.async([]() {}));
+
+  // Stream b prefers its own (still pending) buffer, then gets the one of
+  // stream a once its work is done
+  executor_a.complete_pending_work();
+  double *preferred_buffer = alloc.allocate_on_stream(array_size, executor_b);
+  double *cross_stream_buffer = alloc.allocate_on_stream(array_size, executor_b);
+  if (preferred_buffer != buffer_b) {
+    std::cout << "ERROR: Buffer of the same stream was not preferred"
+              << std::endl;
+    results_correct = false;
+  }
+  if (cross_stream_buffer != buffer_a) {
+    std::cout << "ERROR: Buffer of completed work did not get reused by "
+                 "another stream"
+              << std::endl;
+    results_correct = false;
+  }
+  alloc.deallocate(unstreamed_buffer, array_size);
+  alloc.deallocate_on_stream(preferred_buffer, array_size, executor_b,
+                             executor_b.async([]() {}));
+  alloc.deallocate_on_stream(cross_stream_buffer, array_size, executor_b,
+                             executor_b.async([]() {}));
+
+  // Many buffers in flight on both streams (their work never completes in
+  // between): The streams keep reusing their own buffers
+  std::set<double *> used_buffers;
+  for (size_t repetition = 0; repetition < 4; repetition++) {
+    std::vector<double *> buffers;
+    for (size_t i = 0; i < number_buffers; i++) {
+      Delayed_Executor &executor = i % 2 == 0 ? executor_a : executor_b;
+      buffers.push_back(alloc.allocate_on_stream(array_size, executor));
+      used_buffers.insert(buffers.back());
+    }
+    for (size_t i = 0; i < number_buffers; i++) {
+      Delayed_Executor &executor = i % 2 == 0 ? executor_a : executor_b;
+      alloc.deallocate_on_stream(buffers[i], array_size, executor,
+                                 executor.async([]() {}));
+    }
+  }
+  executor_a.complete_pending_work();
+  executor_b.complete_pending_work();
+  if (used_buffers.size() != number_buffers) {
+    std::cout << "ERROR: " << used_buffers.size() << " buffers used for "
+              << number_buffers << " buffers in flight" << std::endl;
+    results_correct = false;
+  }
+
+  if (results_correct)
+    std::cout << "SUCCESS: Buffers got only reused on their stream or after "
+                 "their work"
+              << std::endl;
+  recycler::force_cleanup(); // Cleanup all buffers and the managers
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2020-2021 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "../include/kokkos_partition_util.hpp"
+#include "../include/stream_manager.hpp"
+#include <boost/program_options.hpp>
+
+// Assert during Release builds as well for this file:
+#undef NDEBUG
+#include <cassert> // reinclude the header to update the definition of assert()
+
+using execution_space_t = Kokkos::DefaultHostExecutionSpace;
+using executor_t =
+    recycler::partitioned_executor<hpx::kokkos::executor<execution_space_t>>;
+constexpr size_t kernel_size = 10000;
+
+/// Gets all executors of the pool at once and runs one kernel on each of them
+/// concurrently -- partitioned is false if the backend does not split the
+/// threads of the host space (all partitions share them)
+template <typename Pool>
+bool test_partitioned_pool(const size_t number_partitions, bool &partitioned) {
+  recycler::host_space_partitions<execution_space_t> partitions(
+      number_partitions);
+  const size_t host_concurrency = execution_space_t{}.concurrency();
+  size_t partition_concurrency = 0;
+  partitioned = true;
+  for (size_t partition = 0; partition < partitions.size(); partition++) {
+    partition_concurrency += partitions[partition].concurrency();
+    if (partitions.size() > 1 &&
+        static_cast<size_t>(partitions[partition].concurrency()) ==
+            host_concurrency)
+      partitioned = false;
+  }
+  std::cout << "Partitions: " << partitions.size() << " with "
+            << partition_concurrency << " threads in total (host space: "
+            << host_concurrency << " threads)" << std::endl;
+  bool results_correct = true;
+  if (partitioned && partition_concurrency > host_concurrency) {
+    std::cout << "ERROR: Partitions use more threads than the host space"
+              << std::endl;
+    results_correct = false;
+  }
+  stream_pool::init<executor_t, Pool>(number_partitions, std::move(partitions));
+
+
+  {
+    std::vector<std::unique_ptr<stream_interface<executor_t, Pool>>> interfaces;
+    std::set<executor_t *> used_executors;
+    for (size_t i = 0; i < number_partitions; i++) {
+      interfaces.emplace_back(
+          std::make_unique<stream_interface<executor_t, Pool>>());
+      used_executors.insert(&interfaces.back()->interface);
+    }
+    // Each executor should get its own partition -- the pools balance the load
+    if (used_executors.size() != number_partitions) {
+      std::cout << "ERROR: Executors got used more than once" << std::endl;
+      results_correct = false;
+    }
+
+    std::vector<Kokkos::View<double *, Kokkos::HostSpace>> results;
+    std::vector<hpx::lcos::future<void>> kernel_futs;
+    for (size_t i = 0; i < number_partitions; i++) {
+      Kokkos::View<double *, Kokkos::HostSpace> result("result", kernel_size);
+      results.push_back(result);
+      kernel_futs.emplace_back(hpx::kokkos::parallel_for_async(
+          "partitioned kernel",
+          Kokkos::RangePolicy<execution_space_t>(
+              interfaces[i]->interface.instance(), 0, kernel_size),
+          KOKKOS_LAMBDA(const int n) { result(n) = 2.0 * n + i; }));
+    }
+    hpx::lcos::when_all(kernel_futs).get();
+    for (size_t i = 0; i < number_partitions; i++) {
+      for (size_t n = 0; n < kernel_size; n++) {
+        if (results[i](n) != 2.0 * n + i) {
+          std::cout << "ERROR: Wrong result of the kernel on partition " << i
+                    << std::endl;
+          results_correct = false;
+          break;
+        }
+      }
+    }
+  }
+  stream_pool::cleanup<executor_t, Pool>();
+  return results_correct;
+}
+
+int hpx_main(int argc, char *argv[]) {
+  std::string filename{};
+  size_t number_partitions = 4;
+  try {
+    boost::program_options::options_description desc{"Options"};
+    desc.add_options()("help", "Help screen")(
+        "outputfile",
+        boost::program_options::value<std::string>(&filename)->default_value(
+            ""),
+        "Redirect stdout/stderr to this file")(
+        "number_partitions",
+        boost::program_options::value<size_t>(&number_partitions)
+            ->default_value(4),
+        "Number of partitions of the host execution space (at most its number "
+        "of threads)");
+
+    boost::program_options::variables_map vm;
+    boost::program_options::parsed_options options =
+        parse_command_line(argc, argv, desc);
+    boost::program_options::store(options, vm);
+    boost::program_options::notify(vm);
+    if (vm.count("help") == 0u) {
+      std::cout << "Running with parameters:" << std::endl
+                << " --filename = " << filename << std::endl
+                << " --number_partitions = " << number_partitions << std::endl;
+    } else {
+      std::cout << desc << std::endl;
+      return hpx::finalize();
+    }
+  } catch (const boost::program_options::error &ex) {
+    std::cerr << "CLI argument problem found: " << ex.what() << '\n';
+  }
+  if (!filename.empty()) {
+    freopen(filename.c_str(), "w", stdout); // NOLINT
+    freopen(filename.c_str(), "w", stderr); // NOLINT
+  }
+
+  {
+    hpx::kokkos::ScopeGuard g(argc, argv);
+    Kokkos::print_configuration(std::cout);
+    number_partitions = std::min(
+        number_partitions,
+        static_cast<size_t>(execution_space_t{}.concurrency()));
+
+    bool results_correct = true;
+    bool partitioned = true;
+    results_correct &= test_partitioned_pool<round_robin_pool<executor_t>>(
+        number_partitions, partitioned);
+    results_correct &= test_partitioned_pool<priority_pool<executor_t>>(
+        number_partitions, partitioned);
+    if (results_correct && !partitioned) {
+      std::cout << "Test information: Host execution space does not partition "
+                   "its threads -- only the results were checked"
+                << std::endl;
+    } else if (results_correct) {
+      std::cout << "SUCCESS: Correct results on all partitions" << std::endl;
+    }
+  }
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
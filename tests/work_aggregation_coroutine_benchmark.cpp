@@ -0,0 +1,307 @@
+// Copyright (c) 2022-2022 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#include <hpx/futures/future.hpp>
+#undef NDEBUG
+
+#include "../include/aggregation_manager.hpp"
+
+#include <boost/program_options.hpp>
+
+#if !defined(CPPUDDLE_HAVE_AGGREGATION_COROUTINES)
+#error "work_aggregation_coroutine_benchmark requires C++20 coroutine support"
+#endif
+
+//===============================================================================
+//===============================================================================
+// Benchmark kernel: does (almost) nothing -- we are only interested in the
+// overhead of the slices and the aggregated launches
+
+std::atomic<size_t> launch_counter = 0;
+void empty_kernel(const size_t aggregated_size) { launch_counter++; }
+
+//===============================================================================
+//===============================================================================
+// TODO Add to shared headerfile (aggregation_test_util.hpp?)...
+//
+/// Dummy CPU executor (providing correct interface but running everything
+/// immediately Intended for testing the aggregation on the CPU, not for
+/// production use!
+struct Dummy_Executor {
+  /// Executor is always ready
+  hpx::lcos::future<void> get_future() {
+    return hpx::make_ready_future();
+  }
+  /// post -- executes immediately
+  template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    f(std::forward<Ts>(ts)...);
+  }
+  /// async -- executores immediately and returns ready future
+  template <typename F, typename... Ts>
+  hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+    f(std::forward<Ts>(ts)...);
+    return hpx::make_ready_future();
+  }
+
+  // OneWay Execution
+  template <typename F, typename... Ts>
+  friend decltype(auto) tag_invoke(hpx::parallel::execution::post_t,
+      Dummy_Executor& exec, F&& f, Ts&&... ts)
+  {
+      return exec.post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  // TwoWay Execution
+  template <typename F, typename... Ts>
+  friend decltype(auto) tag_invoke(
+      hpx::parallel::execution::async_execute_t, Dummy_Executor& exec,
+      F&& f, Ts&&... ts)
+  {
+      return exec.async(
+          std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+};
+
+namespace hpx { namespace parallel { namespace execution {
+    template <>
+    struct is_one_way_executor<Dummy_Executor>
+      : std::true_type
+    {
+        // we support fire and forget without returning a waitable/future
+    };
+
+    template <>
+    struct is_two_way_executor<Dummy_Executor>
+      : std::true_type
+    {
+        // we support returning a waitable/future
+    };
+}}}
+
+//===============================================================================
+//===============================================================================
+// Minimal fire-and-forget coroutine type for the benchmark tasks
+
+struct benchmark_task {
+  struct promise_type {
+    benchmark_task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+static const char kernelname[] = "coroutine_benchmark";
+using executor_pool = aggregation_pool<kernelname, Dummy_Executor,
+                                       round_robin_pool<Dummy_Executor>>;
+
+std::atomic<size_t> finished_calls = 0;
+
+/// Task of the coroutine path: awaits its slice and the aggregated calls
+benchmark_task coroutine_task(const size_t number_calls,
+                              std::atomic<size_t> &remaining_tasks,
+                              hpx::lcos::local::promise<void> &all_done) {
+  {
+    auto slice = co_await executor_pool::co_request_executor_slice();
+    for (size_t call = 0; call < number_calls; call++) {
+      co_await slice.co_async(empty_kernel, slice.number_slices);
+      finished_calls++;
+    }
+  } // slice goes out of scope before we report back
+  if (--remaining_tasks == 0)
+    all_done.set_value();
+}
+
+/// Task of the future-based path: the same work as coroutine_task
+hpx::lcos::future<void> future_task(const size_t number_calls) {
+  auto slice_fut = executor_pool::request_executor_slice();
+  assert(slice_fut.has_value());
+  return slice_fut.value().then([number_calls](auto &&fut) {
+    auto slice = fut.get();
+    for (size_t call = 0; call < number_calls; call++) {
+      slice.async(empty_kernel, slice.number_slices).get();
+      finished_calls++;
+    }
+  });
+}
+
+//===============================================================================
+//===============================================================================
+int hpx_main(int argc, char *argv[]) {
+  // Init parameters
+  size_t number_tasks{0};
+  size_t number_calls{0};
+  size_t max_slices{0};
+  size_t number_aggregation_executors{0};
+  size_t number_underlying_executors{0};
+  size_t repetitions{0};
+  std::string executor_type_string{};
+  Aggregated_Executor_Modes executor_mode{Aggregated_Executor_Modes::EAGER};
+  std::string filename{};
+  {
+    try {
+      boost::program_options::options_description desc{"Options"};
+      desc.add_options()(
+          "help",
+          "Help screen")("number_tasks",
+           boost::program_options::value<size_t>(&number_tasks)
+           ->default_value(4096),
+           "Number of tasks (each using one executor slice)")("number_calls",
+           boost::program_options::value<size_t>(&number_calls)
+           ->default_value(4),
+           "Number of aggregated calls per slice")("max_slices",
+           boost::program_options::value<size_t>(&max_slices)
+           ->default_value(8),
+           "Max number of work aggregation slices")("number_aggregation_executors",
+           boost::program_options::value<size_t>(&number_aggregation_executors)
+           ->default_value(8),
+           "Start number of aggregation executors")("number_underlying_executors",
+           boost::program_options::value<size_t>(&number_underlying_executors)
+           ->default_value(8),
+           "Number of host executors that are used")("repetitions",
+           boost::program_options::value<size_t>(&repetitions)
+           ->default_value(5),
+           "Number of times each path should be run")("executor_type",
+           boost::program_options::value<std::string>(&executor_type_string)
+           ->default_value("EAGER"),
+           "Aggregation executor type [EAGER,STRICT")("outputfile",
+           boost::program_options::value<std::string>(&filename)->default_value(""),
+           "Redirect stdout/stderr to this file");
+
+      boost::program_options::variables_map vm;
+      boost::program_options::parsed_options options =
+          parse_command_line(argc, argv, desc);
+      boost::program_options::store(options, vm);
+      boost::program_options::notify(vm);
+
+      if (vm.count("help") == 0u) {
+        hpx::cout << "Running with parameters:" << std::endl
+                  << "--number_tasks=" << number_tasks << std::endl
+                  << "--number_calls=" << number_calls << std::endl
+                  << "--max_slices=" << max_slices << std::endl
+                  << "--number_aggregation_executors="
+                  << number_aggregation_executors << std::endl
+                  << "--number_underlying_executors="
+                  << number_underlying_executors << std::endl
+                  << "--repetitions=" << repetitions << std::endl
+                  << "--executor_type=" << executor_type_string << std::endl
+                  << "--outputfile=" << filename << std::endl;
+      } else {
+        hpx::cout << desc << std::endl;
+        return hpx::finalize();
+      }
+      if (executor_type_string == "EAGER") {
+        executor_mode = Aggregated_Executor_Modes::EAGER;
+      } else if (executor_type_string == "STRICT") {
+        executor_mode = Aggregated_Executor_Modes::STRICT;
+      } else {
+        std::cerr << "ERROR: Unknown executor mode " << executor_type_string
+                  << "\n Valid choices are: EAGER,STRICT" << std::endl;
+        exit(1);
+      }
+      if (executor_mode == Aggregated_Executor_Modes::STRICT &&
+          number_tasks % max_slices != 0) {
+        std::cerr << "ERROR: STRICT mode requires number_tasks to be a "
+                     "multiple of max_slices"
+                  << std::endl;
+        exit(1);
+      }
+    } catch (const boost::program_options::error &ex) {
+      hpx::cout << "CLI argument problem found: " << ex.what() << '\n';
+    }
+    if (!filename.empty()) {
+      freopen(filename.c_str(), "w", stdout); // NOLINT
+      freopen(filename.c_str(), "w", stderr); // NOLINT
+    }
+  }
+
+  stream_pool::init<Dummy_Executor, round_robin_pool<Dummy_Executor>>(
+      number_underlying_executors);
+  executor_pool::init(number_aggregation_executors, max_slices, executor_mode);
+
+  const size_t expected_calls = number_tasks * number_calls;
+  bool results_correct = true;
+  std::chrono::nanoseconds future_duration{0};
+  std::chrono::nanoseconds coroutine_duration{0};
+  for (size_t repetition = 0; repetition < repetitions; repetition++) {
+    // Future-based path
+    finished_calls = 0;
+    auto begin = std::chrono::high_resolution_clock::now();
+    {
+      std::vector<hpx::lcos::future<void>> futs;
+      for (size_t task_id = 0; task_id < number_tasks; task_id++) {
+        futs.push_back(
+            hpx::async([number_calls]() { return future_task(number_calls); }));
+      }
+      hpx::lcos::when_all(futs).get();
+    }
+    future_duration += std::chrono::high_resolution_clock::now() - begin;
+    if (finished_calls != expected_calls) {
+      hpx::cout << "ERROR in repetition " << repetition
+                << ": Future-based path finished " << finished_calls
+                << " instead of " << expected_calls << " calls" << std::endl;
+      results_correct = false;
+    }
+
+    // Coroutine path
+    finished_calls = 0;
+    begin = std::chrono::high_resolution_clock::now();
+    {
+      std::atomic<size_t> remaining_tasks = number_tasks;
+      hpx::lcos::local::promise<void> all_done;
+      auto all_done_fut = all_done.get_future();
+      std::vector<hpx::lcos::future<void>> futs;
+      for (size_t task_id = 0; task_id < number_tasks; task_id++) {
+        futs.push_back(hpx::async([&]() {
+          coroutine_task(number_calls, remaining_tasks, all_done);
+        }));
+      }
+      hpx::lcos::when_all(futs).get();
+      all_done_fut.get();
+    }
+    coroutine_duration += std::chrono::high_resolution_clock::now() - begin;
+    if (finished_calls != expected_calls) {
+      hpx::cout << "ERROR in repetition " << repetition
+                << ": Coroutine path finished " << finished_calls
+                << " instead of " << expected_calls << " calls" << std::endl;
+      results_correct = false;
+    }
+  }
+  if (results_correct) {
+    hpx::cout << "SUCCESS: Both paths finished all " << expected_calls
+              << " calls in each repetition" << std::endl;
+  }
+
+  const double number_slices =
+      static_cast<double>(number_tasks) * static_cast<double>(repetitions);
+  const double future_per_slice =
+      std::chrono::duration<double, std::micro>(future_duration).count() /
+      number_slices;
+  const double coroutine_per_slice =
+      std::chrono::duration<double, std::micro>(coroutine_duration).count() /
+      number_slices;
+  hpx::cout << std::endl;
+  hpx::cout << "Kernel launch counter: " << launch_counter << std::endl;
+  hpx::cout << "==> Future-based path: " << future_per_slice
+            << " us per slice (" << number_calls << " calls per slice)"
+            << std::endl;
+  hpx::cout << "==> Coroutine path: " << coroutine_per_slice
+            << " us per slice (" << number_calls << " calls per slice)"
+            << std::endl;
+
+  // Flush outout and wait a second for the (non hpx::cout) output to have it in the correct
+  // order for the ctests
+  std::flush(hpx::cout);
+  sleep(1);
+
+  recycler::force_cleanup(); // Cleanup all buffers and the managers
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
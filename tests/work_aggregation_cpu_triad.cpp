@@ -99,6 +99,8 @@ int hpx_main(int argc, char *argv[]) {
   size_t repetitions{0};
   size_t number_aggregation_executors{0};
   size_t number_underlying_executors{0};
+  size_t number_worker_groups{1};
+  size_t watchdog_interval{0};
   bool print_launch_counter{false};
   std::string executor_type_string{};
   Aggregated_Executor_Modes executor_mode{Aggregated_Executor_Modes::EAGER};
@@ -123,7 +125,13 @@ int hpx_main(int argc, char *argv[]) {
            "Start number of aggregation executors")("number_underlying_executors",
            boost::program_options::value<size_t>(&number_underlying_executors)
            ->default_value(8),
-           "Number of host executors that are used")("repetitions",
+           "Number of host executors that are used")("number_worker_groups",
+           boost::program_options::value<size_t>(&number_worker_groups)
+           ->default_value(1),
+           "Number of worker groups the aggregation pool is partitioned into")("watchdog_interval",
+           boost::program_options::value<size_t>(&watchdog_interval)
+           ->default_value(0),
+           "Force-launch starving STRICT aggregations after this many ms without slice requests (0 = off)")("repetitions",
            boost::program_options::value<size_t>(&repetitions)
            ->default_value(1),
            "Number of times the test should be repeated")("print_launch_counter",
@@ -151,6 +159,9 @@ int hpx_main(int argc, char *argv[]) {
                   << number_aggregation_executors << std::endl
                   << "--number_underlying_executors="
                   << number_underlying_executors << std::endl
+                  << "--number_worker_groups=" << number_worker_groups
+                  << std::endl
+                  << "--watchdog_interval=" << watchdog_interval << std::endl
                   << "--repetitions=" << repetitions << std::endl
                   << "--print_launch_counter=" << print_launch_counter
                   << std::endl
@@ -185,7 +196,12 @@ int hpx_main(int argc, char *argv[]) {
   static const char kernelname[] = "cpu_triad";
   using executor_pool = aggregation_pool<kernelname, Dummy_Executor,
                                          round_robin_pool<Dummy_Executor>>;
-  executor_pool::init(number_aggregation_executors, max_slices, executor_mode);
+  executor_pool::init(number_aggregation_executors, max_slices, executor_mode,
+                      number_worker_groups);
+  if (watchdog_interval > 0) {
+    executor_pool::start_watchdog(
+        std::chrono::milliseconds(watchdog_interval));
+  }
 
   using float_t = float;
   //epsilon for comparison
@@ -201,6 +217,7 @@ int hpx_main(int argc, char *argv[]) {
     epsilon = 1.e-6;
   }
 
+  auto begin = std::chrono::high_resolution_clock::now();
   for (size_t repetition = 0; repetition < repetitions; repetition++) {
 
     std::vector<float_t> A(problem_size, 0.0);
@@ -282,8 +299,18 @@ int hpx_main(int argc, char *argv[]) {
                 << std::endl;
     }
   }
+  auto end = std::chrono::high_resolution_clock::now();
   hpx::cout << std::endl;
   hpx::cout << "Kernel launch counter: " << launch_counter << std::endl;
+  hpx::cout << "==> Aggregated triad runs took "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+                   .count()
+            << "ms" << std::endl;
+  if (watchdog_interval > 0) {
+    executor_pool::stop_watchdog();
+    hpx::cout << "==> Number of forced launches: "
+              << executor_pool::get_number_forced_launches() << std::endl;
+  }
 
   // Flush outout and wait a second for the (non hpx::cout) output to have it in the correct
   // order for the ctests
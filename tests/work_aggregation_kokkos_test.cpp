@@ -0,0 +1,216 @@
+// Copyright (c) 2022-2022 Gregor Daiß
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#undef NDEBUG
+
+#include <hpx/futures/future.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include "../include/aggregation_manager.hpp"
+#include "../include/kokkos_aggregation_util.hpp"
+#include "../include/kokkos_buffer_util.hpp"
+
+#include <boost/program_options.hpp>
+
+//===============================================================================
+//===============================================================================
+// TODO Add to shared headerfile (aggregation_test_util.hpp?)...
+//
+/// Dummy CPU executor (providing correct interface but running everything
+/// immediately Intended for testing the aggregation on the CPU, not for
+/// production use!
+struct Dummy_Executor {
+  /// Host execution space instance for the Kokkos kernels of this executor
+  Kokkos::DefaultHostExecutionSpace instance() { return {}; }
+  /// Executor is ready once the kernels on its instance are done
+  hpx::lcos::future<void> get_future() {
+    instance().fence();
+    return hpx::make_ready_future();
+  }
+  /// post -- executes immediately
+  template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    f(std::forward<Ts>(ts)...);
+  }
+  /// async -- executores immediately and returns ready future
+  template <typename F, typename... Ts>
+  hpx::lcos::future<void> async(F &&f, Ts &&...ts) {
+    f(std::forward<Ts>(ts)...);
+    return hpx::make_ready_future();
+  }
+
+  // OneWay Execution
+  template <typename F, typename... Ts>
+  friend decltype(auto) tag_invoke(hpx::parallel::execution::post_t,
+      Dummy_Executor& exec, F&& f, Ts&&... ts)
+  {
+      return exec.post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  // TwoWay Execution
+  template <typename F, typename... Ts>
+  friend decltype(auto) tag_invoke(
+      hpx::parallel::execution::async_execute_t, Dummy_Executor& exec,
+      F&& f, Ts&&... ts)
+  {
+      return exec.async(
+          std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+};
+
+namespace hpx { namespace parallel { namespace execution {
+    template <>
+    struct is_one_way_executor<Dummy_Executor>
+      : std::true_type
+    {
+        // we support fire and forget without returning a waitable/future
+    };
+
+    template <>
+    struct is_two_way_executor<Dummy_Executor>
+      : std::true_type
+    {
+        // we support returning a waitable/future
+    };
+}}}
+
+//===============================================================================
+//===============================================================================
+// Test: Each slice fills its subview of an aggregated view, one aggregated
+// parallel_for (over the subviews of all slices) adds the slice index
+
+constexpr size_t slice_rows = 10;
+constexpr size_t columns = 8;
+std::atomic<size_t> parallel_for_launches = 0;
+
+static const char kernelname[] = "kokkos_subview_kernel";
+using executor_pool = aggregation_pool<kernelname, Dummy_Executor,
+                                       round_robin_pool<Dummy_Executor>>;
+using slice_allocator_t =
+    Allocator_Slice<double, std::allocator<double>, Dummy_Executor, 0>;
+using aggregated_view_t = recycler::aggregated_recycled_view<
+    Kokkos::View<double **, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>,
+    slice_allocator_t, double>;
+
+bool subview_test(const size_t number_tasks) {
+  std::atomic<size_t> wrong_values = 0;
+  std::vector<hpx::lcos::future<void>> slices_done_futs;
+  for (size_t task_id = 0; task_id < number_tasks; task_id++) {
+    auto slice_fut = executor_pool::request_executor_slice();
+    assert(slice_fut.has_value());
+    slices_done_futs.emplace_back(slice_fut.value().then([&](auto &&fut) {
+      auto slice_exec = fut.get();
+      auto alloc =
+          slice_exec.template make_allocator<double, std::allocator<double>>();
+      aggregated_view_t aggregated_view(
+          alloc, slice_exec.number_slices * slice_rows, columns);
+
+      // Fill the subview of this slice
+      auto subview = recycler::get_slice_subview(aggregated_view, slice_exec);
+      assert(subview.extent(0) == slice_rows);
+      assert(subview.extent(1) == columns);
+      for (size_t i = 0; i < slice_rows; i++) {
+        for (size_t j = 0; j < columns; j++) {
+          subview(i, j) = static_cast<double>(i * columns + j);
+        }
+      }
+
+      // One parallel_for for the subviews of all slices
+      typename aggregated_view_t::view_type kernel_view = aggregated_view;
+      recycler::aggregated_parallel_for(
+          slice_exec, "aggregated add", aggregated_view,
+          KOKKOS_LAMBDA(const int64_t slice, const int64_t i, const int64_t j) {
+            if (slice == 0 && i == 0 && j == 0)
+              parallel_for_launches++;
+            kernel_view(i, j) += 1000.0 * slice;
+          })
+          .get();
+
+      // Check the subview of this slice
+      for (size_t i = 0; i < slice_rows; i++) {
+        for (size_t j = 0; j < columns; j++) {
+          if (subview(i, j) != static_cast<double>(i * columns + j) +
+                                   1000.0 * slice_exec.id)
+            wrong_values++;
+        }
+      }
+    }));
+  }
+  hpx::lcos::when_all(slices_done_futs).get();
+  if (wrong_values > 0) {
+    hpx::cout << "ERROR: " << wrong_values
+              << " wrong values in the slice subviews" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+//===============================================================================
+int hpx_main(int argc, char *argv[]) {
+  std::string filename{};
+  {
+    try {
+      boost::program_options::options_description desc{"Options"};
+      desc.add_options()("help", "Help screen")(
+          "outputfile",
+          boost::program_options::value<std::string>(&filename)->default_value(
+              ""),
+          "Redirect stdout/stderr to this file");
+
+      boost::program_options::variables_map vm;
+      boost::program_options::parsed_options options =
+          parse_command_line(argc, argv, desc);
+      boost::program_options::store(options, vm);
+      boost::program_options::notify(vm);
+
+      if (vm.count("help") == 0u) {
+        hpx::cout << "Running with parameters:" << std::endl
+                  << "--outputfile=" << filename << std::endl;
+      } else {
+        hpx::cout << desc << std::endl;
+        return hpx::finalize();
+      }
+    } catch (const boost::program_options::error &ex) {
+      hpx::cout << "CLI argument problem found: " << ex.what() << '\n';
+    }
+    if (!filename.empty()) {
+      freopen(filename.c_str(), "w", stdout); // NOLINT
+      freopen(filename.c_str(), "w", stderr); // NOLINT
+    }
+  }
+  {
+    hpx::kokkos::ScopeGuard scopeGuard(argc, argv);
+    Kokkos::print_configuration(std::cout);
+
+    constexpr size_t max_slices = 4;
+    constexpr size_t repetitions = 5;
+    stream_pool::init<Dummy_Executor, round_robin_pool<Dummy_Executor>>(1);
+    executor_pool::init(1, max_slices, Aggregated_Executor_Modes::STRICT);
+    bool results_correct = true;
+    for (size_t repetition = 0; repetition < repetitions; repetition++) {
+      results_correct &= subview_test(max_slices);
+    }
+    if (results_correct) {
+      hpx::cout << "SUCCESS: Correct slice subviews in all repetitions"
+                << std::endl;
+    }
+    hpx::cout << "Number aggregated parallel_for launches="
+              << parallel_for_launches << std::endl;
+
+    // Flush outout and wait a second for the (non hpx::cout) output to have it
+    // in the correct order for the ctests
+    std::flush(hpx::cout);
+    sleep(1);
+    recycler::force_cleanup(); // Cleanup all buffers and the managers
+  }
+  return hpx::finalize();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.cfg = {"hpx.commandline.allow_unknown=1"};
+  return hpx::init(argc, argv, p);
+}
@@ -5,6 +5,7 @@
 #undef NDEBUG
 
 
+#include <hpx/algorithm.hpp>
 #include <hpx/async_base/apply.hpp>
 #include <hpx/async_base/async.hpp>
 #include <hpx/execution_base/execution.hpp>
@@ -14,6 +15,10 @@
 
 #include <boost/program_options.hpp>
 
+#include <cstring>
+#include <memory>
+#include <numeric>
+
 
 //===============================================================================
 //===============================================================================
@@ -27,6 +32,9 @@ void print_stuff2(int i, double d) {
 }
 void print_stuff3(int i) { hpx::cout << "i is " << i << std::endl; }
 
+size_t consumed_value = 0;
+void consume_value(std::unique_ptr<int> value) { consumed_value += *value; }
+
 size_t add_pointer_launches = 0.0;
 template <typename T>
 void add_pointer(size_t aggregation_size, T *A, T *B, T *C) {
@@ -594,6 +602,1130 @@ void pointer_add_test(void) {
   hpx::cout << std::endl;
 }
 
+void multi_slice_test(void) {
+  hpx::cout << "Host aggregated add pointer example with a multi-slice"
+            << std::endl;
+  hpx::cout << "------------------------------------------------------"
+            << std::endl;
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<float> erg(512);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t launches_before = add_pointer_launches;
+
+    // Both the single slice and the multi-slice (3 slices) run the same
+    // function: each fills and reads back the parts of its local slices
+    auto slice_task = [&erg](auto &&fut) {
+      auto slice_exec = fut.get();
+      hpx::cout << "Got slice with ID " << slice_exec.id << " and "
+                << slice_exec.number_local_slices << " local slices"
+                << std::endl;
+      // Get slice allocator
+      auto alloc =
+          slice_exec.template make_allocator<float, std::allocator<float>>();
+      // Get slice buffers
+      std::vector<float, decltype(alloc)> A(128 * slice_exec.number_slices,
+                                            float{}, alloc);
+      std::vector<float, decltype(alloc)> B(128 * slice_exec.number_slices,
+                                            float{}, alloc);
+      std::vector<float, decltype(alloc)> C(128 * slice_exec.number_slices,
+                                            float{}, alloc);
+      // Fill slice buffers
+      const size_t start = slice_exec.id * 128;
+      const size_t end = (slice_exec.id + slice_exec.number_local_slices) * 128;
+      for (size_t i = start; i < end; i++) {
+        A[i] = i / 128 + 1;
+        B[i] = 2 * (i / 128);
+      }
+
+      // Run add function
+      auto kernel_fut =
+          slice_exec.async(add_pointer<float>, slice_exec.number_slices * 128,
+                           A.data(), B.data(), C.data());
+      // Sync immediately
+      kernel_fut.get();
+
+      // Write results into erg buffer
+      for (size_t i = start; i < end; i++) {
+        erg[i] = C[i];
+      }
+    };
+
+    auto slice_fut1 = agg_exec.request_executor_slice();
+    if (slice_fut1.has_value()) {
+      slices_done_futs.emplace_back(slice_fut1.value().then(slice_task));
+    } else {
+      hpx::cout << "ERROR: Slice 1 was not created properly" << std::endl;
+      throw std::runtime_error("ERROR: Slice 1 was not created properly");
+    }
+    // Does not fit anymore -- should fail as a unit
+    auto too_large_fut = agg_exec.request_executor_slices(4);
+    if (too_large_fut.has_value()) {
+      hpx::cout << "ERROR: Multi-slice exceeding the aggregation was created"
+                << std::endl;
+      throw std::runtime_error(
+          "ERROR: Multi-slice exceeding the aggregation was created");
+    }
+    auto slice_fut2 = agg_exec.request_executor_slices(3);
+    if (slice_fut2.has_value()) {
+      slices_done_futs.emplace_back(slice_fut2.value().then(slice_task));
+    } else {
+      hpx::cout << "ERROR: Multi-slice was not created properly" << std::endl;
+      throw std::runtime_error("ERROR: Multi-slice was not created properly");
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number multi-slice add_pointer_launches="
+              << add_pointer_launches - launches_before << std::endl;
+    assert(add_pointer_launches - launches_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 4; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  hpx::cout << std::endl;
+}
+
+void withdrawal_test(void) {
+  hpx::cout << "Host aggregated add pointer example with a withdrawn slice"
+            << std::endl;
+  hpx::cout << "----------------------------------------------------------"
+            << std::endl;
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<float> erg(512);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t launches_before = add_pointer_launches;
+
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg, task_id](auto &&fut) {
+            auto slice_exec = fut.get();
+            slice_exec.post(print_stuff1, 1);
+            // The last task has nothing to do after the first call
+            if (task_id == 3) {
+              hpx::cout << "Withdrawing slice " << slice_exec.id << std::endl;
+              slice_exec.withdraw();
+              return;
+            }
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            std::vector<float, decltype(alloc)> A(
+                128 * slice_exec.number_slices, float{}, alloc);
+            std::vector<float, decltype(alloc)> B(
+                128 * slice_exec.number_slices, float{}, alloc);
+            std::vector<float, decltype(alloc)> C(
+                128 * slice_exec.number_slices, float{}, alloc);
+            // Fill slice buffers
+            for (int i = slice_exec.id * 128; i < (slice_exec.id + 1) * 128;
+                 i++) {
+              A[i] = task_id + 1;
+              B[i] = 2 * task_id;
+            }
+
+            // Run add function
+            auto kernel_fut = slice_exec.async(
+                add_pointer<float>, slice_exec.number_slices * 128, A.data(),
+                B.data(), C.data());
+            // Sync immediately
+            kernel_fut.get();
+
+            // Write results into erg buffer
+            for (int i = task_id * 128, j = slice_exec.id * 128;
+                 i < (task_id + 1) * 128; i++, j++) {
+              erg[i] = C[j];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number withdrawal add_pointer_launches="
+              << add_pointer_launches - launches_before << std::endl;
+    assert(add_pointer_launches - launches_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 3; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  // The withdrawal completes an async call with a move-only argument: It gets
+  // launched with the (moved) arguments of the first slice
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        2, Aggregated_Executor_Modes::STRICT};
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    hpx::lcos::local::promise<void> call_visited;
+    hpx::lcos::shared_future<void> call_visited_fut =
+        call_visited.get_shared_future();
+    consumed_value = 0;
+    for (size_t task_id = 0; task_id < 2; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(slice_fut.value().then(
+          [&call_visited, call_visited_fut](auto &&fut) {
+            auto slice_exec = fut.get();
+            if (slice_exec.id == 0) {
+              auto kernel_fut =
+                  slice_exec.async(consume_value, std::make_unique<int>(42));
+              call_visited.set_value();
+              kernel_fut.get();
+            } else {
+              call_visited_fut.get();
+              hpx::cout << "Withdrawing slice " << slice_exec.id << std::endl;
+              slice_exec.withdraw();
+            }
+          }));
+    }
+    hpx::lcos::when_all(slices_done_futs).get();
+    hpx::cout << "Consumed value of the withdrawal launch: " << consumed_value
+              << std::endl;
+    assert(consumed_value == 42);
+  }
+  hpx::cout << std::endl;
+}
+
+void fixed_capacity_test(void) {
+  hpx::cout << "Host aggregated add pointer example (fixed-capacity executors)"
+            << std::endl;
+  hpx::cout << "--------------------------------------------------------------"
+            << std::endl;
+  static const char kernelname3[] = "kernel3";
+  using kernel_pool3 = aggregation_pool<kernelname3, Dummy_Executor,
+                                        round_robin_pool<Dummy_Executor>, 4>;
+  kernel_pool3::init(1, 4, Aggregated_Executor_Modes::STRICT);
+  {
+    std::vector<float> erg(1024);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t launches_before = add_pointer_launches;
+
+    for (size_t task_id = 0; task_id < 8; task_id++) {
+      auto slice_fut = kernel_pool3::request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg, task_id](auto &&fut) {
+            auto slice_exec = fut.get();
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            std::vector<float, decltype(alloc)> A(
+                128 * slice_exec.number_slices, float{}, alloc);
+            std::vector<float, decltype(alloc)> B(
+                128 * slice_exec.number_slices, float{}, alloc);
+            std::vector<float, decltype(alloc)> C(
+                128 * slice_exec.number_slices, float{}, alloc);
+            // Fill slice buffers
+            for (int i = slice_exec.id * 128; i < (slice_exec.id + 1) * 128;
+                 i++) {
+              A[i] = task_id + 1;
+              B[i] = 2 * task_id;
+            }
+
+            // Run add function
+            auto kernel_fut = slice_exec.async(
+                add_pointer<float>, slice_exec.number_slices * 128, A.data(),
+                B.data(), C.data());
+            // Sync immediately
+            kernel_fut.get();
+
+            // Write results into erg buffer
+            for (int i = task_id * 128, j = slice_exec.id * 128;
+                 i < (task_id + 1) * 128; i++, j++) {
+              erg[i] = C[j];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number fixed-capacity add_pointer_launches="
+              << add_pointer_launches - launches_before << std::endl;
+    assert(add_pointer_launches - launches_before == 2);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 8; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+
+    // More slices than the compile-time capacity should be rejected
+    try {
+      Aggregated_Executor<Dummy_Executor, 4> too_large_exec{
+          8, Aggregated_Executor_Modes::STRICT};
+      hpx::cout << "ERROR: Fixed-capacity executor exceeding its capacity "
+                   "was created"
+                << std::endl;
+    } catch (const std::runtime_error &e) {
+      hpx::cout << "Rejected fixed-capacity executor: " << e.what()
+                << std::endl;
+    }
+  }
+  hpx::cout << std::endl;
+}
+
+std::atomic<size_t> add_element_calls = 0;
+template <typename T> void add_element(size_t i, T *A, T *B, T *C) {
+  add_element_calls++;
+  C[i] = B[i] + A[i];
+}
+
+void bulk_test(void) {
+  hpx::cout << "Host aggregated add example (bulk execution)" << std::endl;
+  hpx::cout << "--------------------------------------------" << std::endl;
+  {
+    using slice_t = Aggregated_Executor<Dummy_Executor>::Executor_Slice;
+    static_assert(hpx::parallel::execution::is_bulk_two_way_executor<
+                  slice_t>::value);
+    static_assert(hpx::parallel::execution::is_bulk_one_way_executor<
+                  slice_t>::value);
+    static_assert(!is_aggregated_executor_slice_v<Dummy_Executor>);
+
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<float> erg(512);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    add_element_calls = 0;
+
+    auto slice_task = [&erg](auto &&fut) {
+      auto slice_exec = fut.get();
+      // Get slice allocator
+      auto alloc =
+          slice_exec.template make_allocator<float, std::allocator<float>>();
+      // Get slice buffers
+      std::vector<float, decltype(alloc)> A(128 * slice_exec.number_slices,
+                                            float{}, alloc);
+      std::vector<float, decltype(alloc)> B(128 * slice_exec.number_slices,
+                                            float{}, alloc);
+      std::vector<float, decltype(alloc)> C(128 * slice_exec.number_slices,
+                                            float{}, alloc);
+      // Fill slice buffers
+      const size_t start = slice_exec.id * 128;
+      const size_t end = (slice_exec.id + 1) * 128;
+      for (size_t i = start; i < end; i++) {
+        A[i] = i / 128 + 1;
+        B[i] = 2 * (i / 128);
+      }
+
+      // Run add function for all elements of the aggregated buffers (same
+      // call in all slices -> executed once)
+      std::vector<size_t> shape(128 * slice_exec.number_slices);
+      std::iota(shape.begin(), shape.end(), 0);
+      hpx::parallel::execution::bulk_sync_execute(
+          slice_exec, add_element<float>, shape, A.data(), B.data(),
+          C.data());
+
+      // Write results into erg buffer
+      for (size_t i = start; i < end; i++) {
+        erg[i] = C[i];
+      }
+    };
+
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(slice_fut.value().then(slice_task));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number bulk add_element calls=" << add_element_calls
+              << std::endl;
+    assert(add_element_calls == 512);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 4; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  {
+    // Parallel algorithm with a slice policy: Each task runs hpx::for_each
+    // over its own data (with its own callable) -- the chunks of all slices
+    // get merged into one aggregated launch
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<std::vector<float>> task_data(4, std::vector<float>(100));
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&task_data, task_id](auto &&fut) {
+            auto slice_exec = fut.get();
+            auto &data = task_data[task_id];
+            std::iota(data.begin(), data.end(), 0.0f);
+            const float offset = 1000.0f * task_id;
+            hpx::for_each(hpx::execution::par.on(std::move(slice_exec)),
+                          data.begin(), data.end(),
+                          [offset](float &x) { x += offset; });
+          }));
+    }
+    hpx::lcos::when_all(slices_done_futs).get();
+    hpx::cout << "Checking hpx::for_each results of all tasks..." << std::endl;
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      for (size_t i = 0; i < task_data[task_id].size(); i++) {
+        if (task_data[task_id][i] != 1000.0f * task_id + i) {
+          hpx::cout << "ERROR: hpx::for_each skipped element " << i
+                    << " of task " << task_id << std::endl;
+        }
+        assert(task_data[task_id][i] == 1000.0f * task_id + i);
+      }
+    }
+  }
+  hpx::cout << std::endl;
+}
+
+void launch_plan_test(void) {
+  hpx::cout << "Host aggregated add pointer example (recorded launch plan)"
+            << std::endl;
+  hpx::cout << "----------------------------------------------------------"
+            << std::endl;
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    agg_exec.record_launch_plan();
+    const size_t launches_before = add_pointer_launches;
+    std::vector<float *> round_buffers;
+
+    for (size_t round = 0; round < 3; round++) {
+      std::vector<float> erg(512);
+      std::vector<hpx::lcos::future<void>> slices_done_futs;
+      float *round_buffer = nullptr;
+      auto slice_task = [&erg, &round_buffer](auto &&fut) {
+        auto slice_exec = fut.get();
+        // Get slice allocator
+        auto alloc =
+            slice_exec.template make_allocator<float, std::allocator<float>>();
+        // Get slice buffers
+        std::vector<float, decltype(alloc)> A(128 * slice_exec.number_slices,
+                                              float{}, alloc);
+        std::vector<float, decltype(alloc)> B(128 * slice_exec.number_slices,
+                                              float{}, alloc);
+        std::vector<float, decltype(alloc)> C(128 * slice_exec.number_slices,
+                                              float{}, alloc);
+        if (slice_exec.id == 0)
+          round_buffer = A.data();
+        // Fill slice buffers
+        const size_t start = slice_exec.id * 128;
+        const size_t end = (slice_exec.id + 1) * 128;
+        for (size_t i = start; i < end; i++) {
+          A[i] = i / 128 + 1;
+          B[i] = 2 * (i / 128);
+        }
+
+        // Run add function
+        auto kernel_fut =
+            slice_exec.async(add_pointer<float>, slice_exec.number_slices * 128,
+                             A.data(), B.data(), C.data());
+        // Sync immediately
+        kernel_fut.get();
+
+        // Write results into erg buffer
+        for (size_t i = start; i < end; i++) {
+          erg[i] = C[i];
+        }
+      };
+
+      for (size_t task_id = 0; task_id < 4; task_id++) {
+        auto slice_fut = agg_exec.request_executor_slice();
+        if (!slice_fut.has_value()) {
+          hpx::cout << "ERROR: Slice " << task_id + 1
+                    << " was not created properly" << std::endl;
+          throw std::runtime_error("ERROR: Slice was not created properly");
+        }
+        slices_done_futs.emplace_back(slice_fut.value().then(slice_task));
+      }
+      auto final_fut = hpx::lcos::when_all(slices_done_futs);
+      final_fut.get();
+      round_buffers.push_back(round_buffer);
+
+      for (int slice = 0; slice < 4; slice++) {
+        for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+          assert(erg[i] == 3 * slice + 1);
+        }
+      }
+    }
+    // Replayed rounds reuse the recorded buffers
+    if (round_buffers[1] != round_buffers[0] ||
+        round_buffers[2] != round_buffers[0]) {
+      hpx::cout << "ERROR: Replayed rounds did not reuse the buffers of the "
+                   "launch plan"
+                << std::endl;
+    }
+    agg_exec.discard_launch_plan();
+
+    hpx::cout << "Number launch plan add_pointer_launches="
+              << add_pointer_launches - launches_before << std::endl;
+    assert(add_pointer_launches - launches_before == 3);
+    hpx::cout << "Number launch plan replays="
+              << agg_exec.get_number_plan_replays() << std::endl;
+    assert(agg_exec.get_number_plan_replays() == 2);
+  }
+  hpx::cout << std::endl;
+}
+
+size_t scale_pointer_launches = 0;
+template <typename T>
+void scale_pointer(size_t aggregation_size, T factor, T *C, T *D) {
+  scale_pointer_launches++;
+  for (size_t i = 0; i < aggregation_size; i++) {
+    D[i] = factor * C[i];
+  }
+}
+
+void fused_test(void) {
+  hpx::cout << "Host aggregated add and scale example (fused kernels)"
+            << std::endl;
+  hpx::cout << "-----------------------------------------------------"
+            << std::endl;
+  static const char add_kernelname[] = "add_kernel";
+  static const char scale_kernelname[] = "scale_kernel";
+  using fused_pool =
+      composite_kernel_pool<Dummy_Executor, round_robin_pool<Dummy_Executor>,
+                            add_kernelname, scale_kernelname>;
+  fused_pool::init(1, 4, Aggregated_Executor_Modes::STRICT);
+  {
+    std::vector<float> erg(512);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t add_launches_before = add_pointer_launches;
+    const size_t scale_launches_before = scale_pointer_launches;
+
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = fused_pool::request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg](auto &&fut) {
+            auto slice_exec = fut.get();
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            const size_t aggregated_size = 128 * slice_exec.number_slices;
+            std::vector<float, decltype(alloc)> A(aggregated_size, float{},
+                                                  alloc);
+            std::vector<float, decltype(alloc)> B(aggregated_size, float{},
+                                                  alloc);
+            std::vector<float, decltype(alloc)> C(aggregated_size, float{},
+                                                  alloc);
+            std::vector<float, decltype(alloc)> D(aggregated_size, float{},
+                                                  alloc);
+            // Fill slice buffers
+            const size_t start = slice_exec.id * 128;
+            const size_t end = (slice_exec.id + 1) * 128;
+            for (size_t i = start; i < end; i++) {
+              A[i] = i / 128 + 1;
+              B[i] = 2 * (i / 128);
+            }
+
+            // Run add and scale kernel within one aggregated launch
+            auto kernel_fut = slice_exec.fused_async(
+                make_tuple_supporting_references(add_pointer<float>,
+                                                 aggregated_size, A.data(),
+                                                 B.data(), C.data()),
+                make_tuple_supporting_references(scale_pointer<float>,
+                                                 aggregated_size, 2.0f,
+                                                 C.data(), D.data()));
+            // Sync immediately
+            kernel_fut.get();
+
+            // Write results into erg buffer
+            for (size_t i = start; i < end; i++) {
+              erg[i] = D[i];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number fused add_pointer_launches="
+              << add_pointer_launches - add_launches_before
+              << " scale_pointer_launches="
+              << scale_pointer_launches - scale_launches_before << std::endl;
+    assert(add_pointer_launches - add_launches_before == 1);
+    assert(scale_pointer_launches - scale_launches_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 4; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 2 * (3 * slice + 1));
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  hpx::cout << std::endl;
+}
+
+/// Runs number_tasks add_pointer tasks on hierarchical slices (requested from
+/// HPX tasks if requested_in_tasks) -- each task checks the results of its
+/// own slice. Returns the slice ids that have been handed out
+template <typename hierarchical_pool>
+std::vector<size_t> hierarchical_add_tasks(const size_t number_tasks,
+                                           const bool requested_in_tasks) {
+  std::vector<hpx::lcos::future<size_t>> slices_done_futs;
+  auto add_task = [](void) {
+    auto slice_fut = hierarchical_pool::request_executor_slice();
+    if (!slice_fut.has_value()) {
+      hpx::cout << "ERROR: Slice was not created properly" << std::endl;
+      throw std::runtime_error("ERROR: Slice was not created properly");
+    }
+    return slice_fut.value().then([](auto &&fut) {
+      auto slice_exec = fut.get();
+      auto alloc =
+          slice_exec.template make_allocator<float, std::allocator<float>>();
+      std::vector<float, decltype(alloc)> A(slice_exec.number_slices * 128,
+                                            float{}, alloc);
+      std::vector<float, decltype(alloc)> B(slice_exec.number_slices * 128,
+                                            float{}, alloc);
+      std::vector<float, decltype(alloc)> C(slice_exec.number_slices * 128,
+                                            float{}, alloc);
+      for (size_t i = slice_exec.id * 128; i < (slice_exec.id + 1) * 128;
+           i++) {
+        A[i] = slice_exec.id + 1;
+        B[i] = 2 * slice_exec.id;
+      }
+      slice_exec
+          .async(add_pointer<float>, slice_exec.number_slices * 128, A.data(),
+                 B.data(), C.data())
+          .get();
+      for (size_t i = slice_exec.id * 128; i < (slice_exec.id + 1) * 128;
+           i++) {
+        assert(C[i] == 3 * slice_exec.id + 1);
+      }
+      return slice_exec.id;
+    });
+  };
+  for (size_t task_id = 0; task_id < number_tasks; task_id++) {
+    if (requested_in_tasks) {
+      slices_done_futs.emplace_back(hpx::async(add_task));
+    } else {
+      slices_done_futs.emplace_back(add_task());
+    }
+  }
+  std::vector<size_t> slice_ids;
+  for (auto &slice_done_fut : slices_done_futs) {
+    slice_ids.push_back(slice_done_fut.get());
+  }
+  return slice_ids;
+}
+
+void hierarchical_test(void) {
+  hpx::cout << "Host aggregated add pointer example (hierarchical aggregation)"
+            << std::endl;
+  hpx::cout << "--------------------------------------------------------------"
+            << std::endl;
+  static const char hierarchical_kernelname[] = "hierarchical_add_kernel";
+  using hierarchical_pool =
+      hierarchical_aggregation_pool<hierarchical_kernelname, Dummy_Executor,
+                                    round_robin_pool<Dummy_Executor>>;
+  // 8 slices per launch, aggregated in two sub-batches of 4 slices each
+  hierarchical_pool::init(1, 8, Aggregated_Executor_Modes::STRICT, 4);
+  {
+    std::vector<float> erg(1024);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t launches_before = add_pointer_launches;
+
+    for (size_t task_id = 0; task_id < 8; task_id++) {
+      auto slice_fut = hierarchical_pool::request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg](auto &&fut) {
+            auto slice_exec = fut.get();
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            std::vector<float, decltype(alloc)> A(
+                slice_exec.number_slices * 128, float{}, alloc);
+            std::vector<float, decltype(alloc)> B(
+                slice_exec.number_slices * 128, float{}, alloc);
+            std::vector<float, decltype(alloc)> C(
+                slice_exec.number_slices * 128, float{}, alloc);
+            // Fill slice buffers
+            for (size_t i = slice_exec.id * 128;
+                 i < (slice_exec.id + 1) * 128; i++) {
+              A[i] = slice_exec.id + 1;
+              B[i] = 2 * slice_exec.id;
+            }
+
+            // Run add function
+            auto kernel_fut =
+                slice_exec.async(add_pointer<float>,
+                                 slice_exec.number_slices * 128, A.data(),
+                                 B.data(), C.data());
+            // Sync immediately
+            kernel_fut.get();
+
+            // Write results into erg buffer
+            for (size_t i = slice_exec.id * 128;
+                 i < (slice_exec.id + 1) * 128; i++) {
+              erg[i] = C[i];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number hierarchical add_pointer_launches="
+              << add_pointer_launches - launches_before << std::endl;
+    assert(add_pointer_launches - launches_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 8; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  {
+    // EAGER: A sub-batch that is not full when its multi-slice becomes ready
+    // is handed out anyway -- the remaining slice ids of it remain unused
+    static const char eager_kernelname[] = "hierarchical_eager_add_kernel";
+    using eager_pool =
+        hierarchical_aggregation_pool<eager_kernelname, Dummy_Executor,
+                                      round_robin_pool<Dummy_Executor>>;
+    eager_pool::init(1, 8, Aggregated_Executor_Modes::EAGER, 4);
+    const auto slice_ids = hierarchical_add_tasks<eager_pool>(3, false);
+    hpx::cout << "Number eager hierarchical slices=" << slice_ids.size()
+              << std::endl;
+    assert(slice_ids.size() == 3);
+    for (const auto slice_id : slice_ids)
+      assert(slice_id < 8);
+  }
+  {
+    // Two worker groups: Slices are only aggregated within the worker group
+    // of the requesting thread
+    static const char grouped_kernelname[] = "hierarchical_grouped_add_kernel";
+    using grouped_pool =
+        hierarchical_aggregation_pool<grouped_kernelname, Dummy_Executor,
+                                      round_robin_pool<Dummy_Executor>>;
+    grouped_pool::init(2, 8, Aggregated_Executor_Modes::EAGER, 2, 2);
+    const auto slice_ids = hierarchical_add_tasks<grouped_pool>(16, true);
+    hpx::cout << "Number grouped hierarchical slices=" << slice_ids.size()
+              << std::endl;
+    assert(slice_ids.size() == 16);
+  }
+  hpx::cout << std::endl;
+}
+
+std::atomic<size_t> copy_transfers = 0;
+/// Copy function of the copy_test: counts the issued transfers
+void counting_copy(void *dst, const void *src, const size_t bytes) {
+  copy_transfers++;
+  std::memcpy(dst, src, bytes);
+}
+
+void copy_test(void) {
+  hpx::cout << "Host aggregated copy example" << std::endl;
+  hpx::cout << "----------------------------" << std::endl;
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<float> erg(1024);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t transfers_before = copy_transfers;
+
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg](auto &&fut) {
+            auto slice_exec = fut.get();
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            std::vector<float, decltype(alloc)> A(
+                slice_exec.number_slices * 128, float{}, alloc);
+            std::vector<float, decltype(alloc)> B(
+                slice_exec.number_slices * 256, float{}, alloc);
+            // Local (non-aggregated) source buffer
+            std::vector<float> local(128);
+            // Fill slice buffers
+            for (size_t i = slice_exec.id * 128;
+                 i < (slice_exec.id + 1) * 128; i++) {
+              A[i] = slice_exec.id + 1;
+            }
+            for (size_t i = 0; i < 128; i++) {
+              local[i] = 2 * slice_exec.id;
+            }
+
+            // Parts of the aggregated buffer A: coalesced into one transfer
+            auto copy_fut = slice_exec.aggregated_copy(
+                counting_copy, B.data(), A.data() + slice_exec.id * 128,
+                slice_exec.id * 128 * sizeof(float), 128 * sizeof(float));
+            copy_fut.get();
+            // Separate buffers: one transfer per slice (default memcpy)
+            copy_fut = slice_exec.aggregated_copy(
+                B.data(), local.data(),
+                (slice_exec.number_slices + slice_exec.id) * 128 *
+                    sizeof(float),
+                128 * sizeof(float));
+            copy_fut.get();
+
+            // Write results into erg buffer
+            for (size_t i = slice_exec.id * 128;
+                 i < (slice_exec.id + 1) * 128; i++) {
+              erg[i] = B[i] + B[slice_exec.number_slices * 128 + i];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number coalesced copy transfers="
+              << copy_transfers - transfers_before << std::endl;
+    assert(copy_transfers - transfers_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 4; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  hpx::cout << std::endl;
+}
+
+void dependency_group_test(void) {
+  hpx::cout << "Host aggregated add and scale example (dependency groups)"
+            << std::endl;
+  hpx::cout << "---------------------------------------------------------"
+            << std::endl;
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<float> erg(512);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t add_launches_before = add_pointer_launches;
+    const size_t scale_launches_before = scale_pointer_launches;
+
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg](auto &&fut) {
+            auto slice_exec = fut.get();
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            const size_t aggregated_size = 128 * slice_exec.number_slices;
+            std::vector<float, decltype(alloc)> A(aggregated_size, float{},
+                                                  alloc);
+            std::vector<float, decltype(alloc)> B(aggregated_size, float{},
+                                                  alloc);
+            std::vector<float, decltype(alloc)> C(aggregated_size, float{},
+                                                  alloc);
+            std::vector<float, decltype(alloc)> D(aggregated_size, float{},
+                                                  alloc);
+            // Fill slice buffers
+            const size_t start = slice_exec.id * 128;
+            const size_t end = (slice_exec.id + 1) * 128;
+            for (size_t i = start; i < end; i++) {
+              A[i] = i / 128 + 1;
+              B[i] = 2 * (i / 128);
+            }
+
+            // Independent add and scale kernels in different dependency
+            // groups: Every other slice issues (and waits for) the scale
+            // kernel first
+            if (slice_exec.id % 2 == 0) {
+              auto add_fut = slice_exec.async_in_group(
+                  1, add_pointer<float>, aggregated_size, A.data(), B.data(),
+                  C.data());
+              auto scale_fut = slice_exec.async_in_group(
+                  2, scale_pointer<float>, aggregated_size, 2.0f, A.data(),
+                  D.data());
+              add_fut.get();
+              scale_fut.get();
+            } else {
+              slice_exec
+                  .async_in_group(2, scale_pointer<float>, aggregated_size,
+                                  2.0f, A.data(), D.data())
+                  .get();
+              slice_exec
+                  .async_in_group(1, add_pointer<float>, aggregated_size,
+                                  A.data(), B.data(), C.data())
+                  .get();
+            }
+
+            // Write results into erg buffer
+            for (size_t i = start; i < end; i++) {
+              erg[i] = C[i] + D[i];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number dependency group add_pointer_launches="
+              << add_pointer_launches - add_launches_before
+              << " scale_pointer_launches="
+              << scale_pointer_launches - scale_launches_before << std::endl;
+    assert(add_pointer_launches - add_launches_before == 1);
+    assert(scale_pointer_launches - scale_launches_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 4; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 5 * slice + 3);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+  }
+  hpx::cout << std::endl;
+}
+
+#if defined(CPPUDDLE_HAVE_AGGREGATION_SENDERS)
+void sender_test(void) {
+  hpx::cout << "Host aggregated add pointer example (sender interface)"
+            << std::endl;
+  hpx::cout << "------------------------------------------------------"
+            << std::endl;
+  {
+    Aggregated_Executor<Dummy_Executor> agg_exec{
+        4, Aggregated_Executor_Modes::STRICT};
+    std::vector<float> erg(512);
+    std::vector<hpx::lcos::future<void>> slices_done_futs;
+    const size_t launches_before = add_pointer_launches;
+
+    for (size_t task_id = 0; task_id < 4; task_id++) {
+      auto slice_fut = agg_exec.request_executor_slice();
+      if (!slice_fut.has_value()) {
+        hpx::cout << "ERROR: Slice " << task_id + 1
+                  << " was not created properly" << std::endl;
+        throw std::runtime_error("ERROR: Slice was not created properly");
+      }
+      slices_done_futs.emplace_back(
+          slice_fut.value().then([&erg, task_id](auto &&fut) {
+            auto slice_exec = fut.get();
+            // Get slice allocator
+            auto alloc = slice_exec.template make_allocator<
+                float, std::allocator<float>>();
+            // Get slice buffers
+            std::vector<float, decltype(alloc)> A(
+                128 * slice_exec.number_slices, float{}, alloc);
+            std::vector<float, decltype(alloc)> B(
+                128 * slice_exec.number_slices, float{}, alloc);
+            std::vector<float, decltype(alloc)> C(
+                128 * slice_exec.number_slices, float{}, alloc);
+            // Fill slice buffers
+            for (int i = slice_exec.id * 128; i < (slice_exec.id + 1) * 128;
+                 i++) {
+              A[i] = task_id + 1;
+              B[i] = 2 * task_id;
+            }
+
+            // Run add function as aggregated bulk stage (128 elements per
+            // slice) and wait for the aggregated launch
+            hpx::this_thread::experimental::sync_wait(aggregated_bulk(
+                hpx::execution::experimental::schedule(slice_exec), 128,
+                add_pointer<float>, A.data(), B.data(), C.data()));
+
+            // Write results into erg buffer
+            for (int i = task_id * 128, j = slice_exec.id * 128;
+                 i < (task_id + 1) * 128; i++, j++) {
+              erg[i] = C[j];
+            }
+          }));
+    }
+    hpx::cout << "Requested all executors!" << std::endl;
+    hpx::cout << "Realizing by requesting final fut..." << std::endl;
+    auto final_fut = hpx::lcos::when_all(slices_done_futs);
+    final_fut.get();
+
+    hpx::cout << "Number sender add_pointer_launches="
+              << add_pointer_launches - launches_before << std::endl;
+    assert(add_pointer_launches - launches_before == 1);
+    hpx::cout << "Checking erg: " << std::endl;
+    for (int slice = 0; slice < 4; slice++) {
+      for (int i = slice * 128; i < (slice + 1) * 128; i++) {
+        assert(erg[i] == 3 * slice + 1);
+        hpx::cout << erg[i] << " ";
+      }
+    }
+    hpx::cout << std::endl;
+
+    // Stream interfaces can start sender pipelines as well
+    stream_interface<Dummy_Executor, round_robin_pool<Dummy_Executor>> stream;
+    hpx::this_thread::experimental::sync_wait(
+        hpx::execution::experimental::schedule(stream));
+    hpx::cout << "Scheduled on stream interface" << std::endl;
+  }
+  hpx::cout << std::endl;
+}
+#endif
+
+#if defined(CPPUDDLE_HAVE_COUNTERS)
+/// Requests a slice, retrying until the executor has started its next round
+hpx::lcos::future<Aggregated_Executor<Dummy_Executor>::Executor_Slice>
+wait_for_slice(Aggregated_Executor<Dummy_Executor> &executor) {
+  auto slice_fut = executor.request_executor_slice();
+  while (!slice_fut.has_value()) {
+    hpx::this_thread::yield();
+    slice_fut = executor.request_executor_slice();
+  }
+  return std::move(slice_fut.value());
+}
+
+/// Each of number_executors tasks runs aggregation rounds (two slices
+/// allocating two aggregated buffers) on its own aggregation executor --
+/// returns the contended recycler location locks
+size_t aggregated_contended_locks(
+    std::deque<Aggregated_Executor<Dummy_Executor>> &executors,
+    const bool shared_location) {
+  constexpr size_t number_executors = 4;
+  constexpr size_t number_rounds = 2000;
+  for (size_t i = 0; i < number_executors; i++) {
+    // Shared location: All aggregated buffers use location 0 (like they did
+    // before the executors got locations of their own)
+    executors.emplace_back(2, Aggregated_Executor_Modes::STRICT,
+                           shared_location ? 0 : i);
+  }
+  const size_t contended_before = recycler::detail::buffer_recycler::
+      get_statistics<float, std::allocator<float>>()
+          .number_contended_locks;
+  std::vector<hpx::lcos::future<void>> tasks_done_futs;
+  for (size_t i = 0; i < number_executors; i++) {
+    tasks_done_futs.emplace_back(hpx::async([&executors, i]() {
+      for (size_t round = 0; round < number_rounds; round++) {
+        auto first_fut = wait_for_slice(executors[i]);
+        auto second_slice = wait_for_slice(executors[i]).get();
+        auto first_slice = first_fut.get();
+        auto first_alloc = first_slice.template make_allocator<
+            float, std::allocator<float>>();
+        auto second_alloc = second_slice.template make_allocator<
+            float, std::allocator<float>>();
+        std::vector<float, decltype(first_alloc)> A(512, float{},
+                                                    first_alloc);
+        std::vector<float, decltype(first_alloc)> B(512, float{},
+                                                    first_alloc);
+        std::vector<float, decltype(second_alloc)> A_second(512, float{},
+                                                           second_alloc);
+        std::vector<float, decltype(second_alloc)> B_second(512, float{},
+                                                           second_alloc);
+      }
+    }));
+  }
+  hpx::lcos::when_all(tasks_done_futs).get();
+  return recycler::detail::buffer_recycler::get_statistics<
+             float, std::allocator<float>>()
+             .number_contended_locks -
+         contended_before;
+}
+#endif
+
+void contention_test(void) {
+  hpx::cout << "Recycler lock contention of concurrent aggregation executors"
+            << std::endl;
+  hpx::cout << "------------------------------------------------------------"
+            << std::endl;
+#if defined(CPPUDDLE_HAVE_COUNTERS)
+  // Static: The launch continuations of the last rounds may still be running
+  // once all slices are done
+  static std::deque<Aggregated_Executor<Dummy_Executor>> shared_executors;
+  static std::deque<Aggregated_Executor<Dummy_Executor>> own_executors;
+  const size_t shared_contention =
+      aggregated_contended_locks(shared_executors, true);
+  const size_t own_contention = aggregated_contended_locks(own_executors, false);
+  hpx::cout << "Contended location locks with a shared location: "
+            << shared_contention << std::endl;
+  hpx::cout << "Contended location locks with own locations: "
+            << own_contention << std::endl;
+  // Executors with locations of their own should hardly ever wait for each
+  // other -- a small shared contention is too noisy to compare against
+  if (shared_contention < 100) {
+    hpx::cout << "Test information: Too little contention with a shared "
+                 "location to compare"
+              << std::endl;
+  } else if (own_contention * 4 > shared_contention) {
+    hpx::cout << "ERROR: Own recycler locations do not reduce the contention"
+              << std::endl;
+  } else {
+    hpx::cout << "SUCCESS: Own recycler locations reduce the contention"
+              << std::endl;
+  }
+#else
+  hpx::cout << "Test information: Contention is only counted with "
+               "CPPUDDLE_HAVE_COUNTERS"
+            << std::endl;
+#endif
+  hpx::cout << std::endl;
+}
+
 void references_add_test(void) {
   hpx::cout << "Host aggregated add vector example (references used)"
             << std::endl;
@@ -788,7 +1920,11 @@ int hpx_main(int argc, char *argv[]) {
                              ->default_value("all"),
                          "Which scenario to run [sequential_test, "
                          "interruption_test, failure_test, pointer_add_test, "
-                         "references_add_test, all]")("outputfile",
+                         "multi_slice_test, withdrawal_test, "
+                         "fixed_capacity_test, bulk_test, launch_plan_test, "
+                         "fused_test, hierarchical_test, copy_test, "
+                         "dependency_group_test, sender_test, "
+                         "contention_test, references_add_test, all]")("outputfile",
                                                       boost::program_options::
                                                           value<std::string>(
                                                               &filename)
@@ -821,7 +1957,13 @@ int hpx_main(int argc, char *argv[]) {
   }
   if (scenario != "sequential_test" && scenario != "interruption_test" &&
       scenario != "failure_test" && scenario != "pointer_add_test" &&
-      scenario != "references_add_test" && scenario != "all") {
+      scenario != "multi_slice_test" && scenario != "withdrawal_test" &&
+      scenario != "fixed_capacity_test" && scenario != "bulk_test" &&
+      scenario != "launch_plan_test" && scenario != "fused_test" &&
+      scenario != "hierarchical_test" && scenario != "copy_test" &&
+      scenario != "dependency_group_test" && scenario != "sender_test" &&
+      scenario != "contention_test" && scenario != "references_add_test" &&
+      scenario != "all") {
     hpx::cout << "ERROR: Invalid scenario specified (see --help)" << std::endl;
     return hpx::finalize();
   }
@@ -849,6 +1991,41 @@ int hpx_main(int argc, char *argv[]) {
   if (scenario == "pointer_add_test" || scenario == "all") {
     pointer_add_test();
   }
+  if (scenario == "multi_slice_test" || scenario == "all") {
+    multi_slice_test();
+  }
+  if (scenario == "withdrawal_test" || scenario == "all") {
+    withdrawal_test();
+  }
+  if (scenario == "fixed_capacity_test" || scenario == "all") {
+    fixed_capacity_test();
+  }
+  if (scenario == "bulk_test" || scenario == "all") {
+    bulk_test();
+  }
+  if (scenario == "launch_plan_test" || scenario == "all") {
+    launch_plan_test();
+  }
+  if (scenario == "fused_test" || scenario == "all") {
+    fused_test();
+  }
+  if (scenario == "hierarchical_test" || scenario == "all") {
+    hierarchical_test();
+  }
+  if (scenario == "copy_test" || scenario == "all") {
+    copy_test();
+  }
+  if (scenario == "dependency_group_test" || scenario == "all") {
+    dependency_group_test();
+  }
+#if defined(CPPUDDLE_HAVE_AGGREGATION_SENDERS)
+  if (scenario == "sender_test" || scenario == "all") {
+    sender_test();
+  }
+#endif
+  if (scenario == "contention_test" || scenario == "all") {
+    contention_test();
+  }
   if (scenario == "references_add_test" || scenario == "all") {
     references_add_test();
   }